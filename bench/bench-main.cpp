@@ -0,0 +1,565 @@
+// Benchmark fim-a-fim dos clientes de apresentação.
+//
+// Sobe um servidor HTTP falso (mock-server) que segue um roteiro de trocas
+// de slide e mede, com os clientes reais (HolyricsClient/ProPresentClient),
+// quanto tempo cada troca leva para chegar ao on_verse_changed, quantas se
+// perdem ou chegam atrasadas, e o custo de CPU e de alocações por consulta.
+// Também compara o scanner/blank check atuais com o caminho antigo
+// (QJsonDocument + QRegularExpression), sobre os payloads do servidor falso,
+// os de bench/fixtures e os corpos gravados em traces .aht (--trace).
+//
+// Saída em JSON Lines (um objeto por cenário) para acompanhar regressões.
+
+#include "bench-util.hpp"
+#include "mock-server.hpp"
+
+#include "feed-trace.hpp"
+#include "holyrics-client.hpp"
+#include "json-scanner.hpp"
+#include "latency-stats.hpp"
+#include "plugin-log.hpp"
+#include "propresent-client.hpp"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QTimer>
+#include <cstdio>
+#include <random>
+#include <util/base.h>
+#include <util/platform.h>
+
+struct BenchOptions {
+  QList<int> intervals_ms = {50, 100, 250, 500};
+  QStringList clients = {"Holyrics", "ProPresent"};
+  QStringList transports = {"Qt", "KeepAlive"};
+  int transitions = 20;
+  int late_margin_ms = 50;
+  int micro_iterations = 100000;
+  bool run_micro = true;
+  QString fixtures_dir = QStringLiteral(AUTO_HIDE_BENCH_FIXTURES_DIR);
+  QStringList traces;
+};
+
+static QFile output_file;
+
+static void emit_record(const QJsonObject &record) {
+  output_file.write(QJsonDocument(record).toJson(QJsonDocument::Compact));
+  output_file.write("\n");
+  output_file.flush();
+}
+
+// Só avisos/erros do plugin, e no stderr (stdout é a saída do benchmark)
+static void bench_log_handler(int level, const char *format, va_list args,
+                              void *) {
+  if (level > LOG_WARNING)
+    return;
+  vfprintf(stderr, format, args);
+  fputc('\n', stderr);
+}
+
+// Roda o event loop até *done virar true (ou o tempo acabar)
+static bool wait_for(QEventLoop *&current_loop, const bool &done,
+                     int timeout_ms) {
+  if (done)
+    return true;
+
+  QEventLoop loop;
+  current_loop = &loop;
+  QTimer::singleShot(timeout_ms, &loop, &QEventLoop::quit);
+  loop.exec();
+  current_loop = nullptr;
+  return done;
+}
+
+static void sleep_in_loop(int ms) {
+  if (ms <= 0)
+    return;
+  QEventLoop loop;
+  QTimer::singleShot(ms, &loop, &QEventLoop::quit);
+  loop.exec();
+}
+
+static double us_to_ms(uint64_t us) { return us / 1000.0; }
+
+static QJsonObject histogram_json(const LatencyHistogram &histogram) {
+  QJsonObject json;
+  json["p50"] = us_to_ms(histogram.percentile(50));
+  json["p95"] = us_to_ms(histogram.percentile(95));
+  json["p99"] = us_to_ms(histogram.percentile(99));
+  json["max"] = us_to_ms(histogram.max());
+  return json;
+}
+
+static IPresentationClient *create_client(const QString &name, int interval_ms,
+                                          PipelineTransport transport) {
+  if (name == "ProPresent") {
+    ProPresentClient *client = new ProPresentClient();
+    client->set_polling_interval(interval_ms);
+    client->set_transport(transport);
+    return client;
+  }
+
+  HolyricsClient *client = new HolyricsClient();
+  client->set_polling_interval(interval_ms);
+  client->set_transport(transport);
+  return client;
+}
+
+static QJsonObject run_scenario(const QString &client_name,
+                                const QString &transport_name, int interval_ms,
+                                const BenchOptions &options) {
+  QJsonObject record;
+  record["kind"] = "e2e";
+  record["client"] = client_name;
+  record["transport"] = transport_name;
+  record["interval_ms"] = interval_ms;
+  record["transitions"] = options.transitions;
+
+  MockPresentationServer server;
+  if (!server.start()) {
+    record["error"] = "servidor falso não subiu";
+    return record;
+  }
+
+  PipelineTransport transport = transport_name == "KeepAlive"
+                                    ? PipelineTransport::KeepAlive
+                                    : PipelineTransport::Qt;
+  IPresentationClient *client =
+      create_client(client_name, interval_ms, transport);
+
+  QEventLoop *current_loop = nullptr;
+  bool expected_state = false;
+  bool detected = false;
+  uint64_t detected_ns = 0;
+  int spurious = 0;
+
+  client->on_verse_changed = [&](bool visible, const TransitionTrace &) {
+    if (visible != expected_state) {
+      spurious++;
+      return;
+    }
+    detected = true;
+    detected_ns = os_gettime_ns();
+    if (current_loop)
+      current_loop->quit();
+  };
+
+  client->connect(QString("http://127.0.0.1:%1").arg(server.port()));
+  // Aquecimento: conexão aberta e estado inicial (sem versículo) lido
+  sleep_in_loop(2 * interval_ms + 200);
+
+  LatencyHistogram latency;
+  int missed = 0;
+  int late = 0;
+  const uint64_t late_threshold_us =
+      uint64_t(interval_ms + options.late_margin_ms) * 1000;
+  const int detection_timeout_ms = 4 * interval_ms + 1000;
+  // Semente fixa: mesmo roteiro em todas as execuções
+  std::mt19937 rng(12345);
+  std::uniform_int_distribution<int> phase(0, interval_ms);
+
+  const quint64 requests_start = server.requests();
+  const quint64 server_cpu_start = server.cpu_ns();
+  const uint64_t cpu_start = process_cpu_ns();
+  const uint64_t allocations_start = allocation_count();
+
+  for (int i = 0; i < options.transitions; i++) {
+    // Fase aleatória em relação ao ciclo de polling
+    sleep_in_loop(phase(rng));
+
+    expected_state = !expected_state;
+    detected = false;
+    server.set_verse(expected_state, i / 2);
+    const uint64_t change_ns = os_gettime_ns();
+
+    if (!wait_for(current_loop, detected, detection_timeout_ms)) {
+      missed++;
+      continue;
+    }
+
+    uint64_t latency_us = (detected_ns - change_ns) / 1000;
+    latency.record(latency_us);
+    if (latency_us > late_threshold_us)
+      late++;
+  }
+
+  const uint64_t allocations = allocation_count() - allocations_start;
+  const uint64_t server_cpu = server.cpu_ns() - server_cpu_start;
+  const uint64_t process_cpu = process_cpu_ns() - cpu_start;
+  const quint64 polls = server.requests() - requests_start;
+
+  client->disconnect();
+  delete client;
+  server.stop();
+
+  const uint64_t client_cpu =
+      process_cpu > server_cpu ? process_cpu - server_cpu : 0;
+
+  record["detected"] = options.transitions - missed;
+  record["missed"] = missed;
+  record["late"] = late;
+  record["spurious"] = spurious;
+  record["late_threshold_ms"] = interval_ms + options.late_margin_ms;
+  record["latency_ms"] = histogram_json(latency);
+  record["polls"] = double(polls);
+  record["cpu_us_per_poll"] =
+      polls ? double(client_cpu) / 1000.0 / double(polls) : 0.0;
+  record["allocations_per_poll"] =
+      polls ? double(allocations) / double(polls) : 0.0;
+  return record;
+}
+
+// Caminho antigo de detecção do Holyrics (antes do scanner)
+static bool legacy_detect_holyrics(const QByteArray &raw) {
+  QJsonDocument doc = QJsonDocument::fromJson(raw);
+  QJsonObject map = doc.object().value("map").toObject();
+  QString type = map.value("type").toString();
+  if (type.compare("MUSIC", Qt::CaseInsensitive) == 0)
+    return true;
+  if (type.compare("BIBLE", Qt::CaseInsensitive) != 0)
+    return false;
+
+  static QRegularExpression html_tag_re("<[^>]*>");
+  QString plain_text = map.value("text").toString().replace(html_tag_re, "");
+  plain_text.replace("&nbsp;", " ", Qt::CaseInsensitive);
+  return !plain_text.trimmed().isEmpty();
+}
+
+static bool scanner_detect_holyrics(const QByteArray &raw) {
+  HolyricsView view;
+  if (scan_holyrics_view(raw, view) != ScanStatus::Complete || !view.has_type)
+    return false;
+  if (view.type.compare("MUSIC", Qt::CaseInsensitive) == 0)
+    return true;
+  if (view.type.compare("BIBLE", Qt::CaseInsensitive) != 0)
+    return false;
+  return !view.has_text || !html_text_is_blank(view.text, view.text_has_escapes);
+}
+
+template <typename F>
+static QJsonObject measure_micro(const char *name, const char *variant,
+                                 int iterations, F &&operation) {
+  volatile bool sink = false;
+  // Aquece caches e estáticos (regex compilada, etc.)
+  for (int i = 0; i < 1000; i++)
+    sink = operation();
+
+  const uint64_t allocations_start = allocation_count();
+  QElapsedTimer timer;
+  timer.start();
+  for (int i = 0; i < iterations; i++)
+    sink = operation();
+  const qint64 elapsed_ns = timer.nsecsElapsed();
+  const uint64_t allocations = allocation_count() - allocations_start;
+  (void)sink;
+
+  QJsonObject record;
+  record["kind"] = "micro";
+  record["name"] = name;
+  record["variant"] = variant;
+  record["iterations"] = iterations;
+  record["ns_per_op"] = double(elapsed_ns) / iterations;
+  record["allocations_per_op"] = double(allocations) / iterations;
+  return record;
+}
+
+// Slide com vários versículos como o Holyrics formata: cada um num <p>
+// com spans aninhados de fonte/cor e &nbsp; entre número e texto (~8 KB)
+static QByteArray long_verses_text() {
+  QByteArray text;
+  for (int verse = 1; text.size() < 8 * 1024; verse++) {
+    text += "<p style=\"text-align: center;\"><span style=\"font-size: "
+            "48px;\"><span style=\"color: #ffff00;\"><sup>" +
+            QByteArray::number(verse) +
+            "</sup></span>&nbsp;<span style=\"color: #ffffff;\">No "
+            "princípio era o Verbo,&nbsp;</span><span style=\"color: "
+            "#ffffff;\">e o Verbo estava com Deus,&nbsp;</span><span "
+            "style=\"color: #ffffff;\">e o Verbo era Deus.</span>"
+            "</span></p>";
+  }
+  return text;
+}
+
+// Mesma estrutura sem nenhum caractere visível (~4 KB): só termina de
+// decidir no fim do texto
+static QByteArray long_blank_text() {
+  QByteArray text;
+  while (text.size() < 4 * 1024) {
+    text += "<p style=\"text-align: center;\"><span style=\"font-size: "
+            "48px;\"><span style=\"color: #ffffff;\">&nbsp;&nbsp;</span>"
+            "&nbsp;<span> </span></span></p><br/>";
+  }
+  return text;
+}
+
+static void run_micro(const BenchOptions &options) {
+  const int n = options.micro_iterations;
+
+  // Mesmos payloads que o servidor falso entrega
+  const struct {
+    const char *variant;
+    bool visible;
+    int hidden_variant;
+  } payloads[] = {
+      {"bible_visible", true, 0},
+      {"bible_blank", false, 0},
+      {"other_type", false, 1},
+  };
+
+  for (const auto &payload : payloads) {
+    QByteArray body = MockPresentationServer::holyrics_body_for(
+        payload.visible, payload.hidden_variant);
+
+    QJsonObject legacy = measure_micro(
+        "holyrics_detect_legacy", payload.variant, n,
+        [&]() { return legacy_detect_holyrics(body); });
+    QJsonObject scanner = measure_micro(
+        "holyrics_detect_scanner", payload.variant, n,
+        [&]() { return scanner_detect_holyrics(body); });
+    emit_record(legacy);
+    emit_record(scanner);
+  }
+
+  // Blank check isolado: texto típico de versículo e de F9, e payloads
+  // longos (vários versículos, muitas tags/&nbsp;) em que o custo cresce
+  // com o tamanho. O branco longo obriga a varredura inteira.
+  const struct {
+    const char *variant;
+    QByteArray text;
+    bool is_long;
+  } texts[] = {
+      {"verse_text",
+       "<p style=\"text-align: center;\">No princípio era o Verbo, e o "
+       "Verbo estava com Deus, e o Verbo era Deus.</p>",
+       false},
+      {"blank_text", "<p>&nbsp;</p><br/><span> </span>", false},
+      {"long_verses_text", long_verses_text(), true},
+      {"long_blank_text", long_blank_text(), true},
+  };
+  // Os longos custam centenas de vezes mais por operação
+  const int long_n = qMax(1, n / 20);
+
+  for (const auto &sample : texts) {
+    const QByteArray &text = sample.text;
+    const QString text_string = QString::fromUtf8(text);
+    const int iterations = sample.is_long ? long_n : n;
+
+    QJsonObject regex = measure_micro(
+        "blank_check_regex", sample.variant, iterations, [&]() {
+          static QRegularExpression html_tag_re("<[^>]*>");
+          QString plain_text = text_string;
+          plain_text.replace(html_tag_re, "");
+          plain_text.replace("&nbsp;", " ", Qt::CaseInsensitive);
+          return plain_text.trimmed().isEmpty();
+        });
+    QJsonObject scanner =
+        measure_micro("blank_check_scanner", sample.variant, iterations,
+                      [&]() { return html_text_is_blank(text, false); });
+    regex["bytes"] = text.size();
+    scanner["bytes"] = text.size();
+    emit_record(regex);
+    emit_record(scanner);
+  }
+}
+
+// Corpos de /view/text.json de fora do servidor falso. Uma operação do
+// micro-benchmark detecta todos os corpos do grupo.
+struct CapturedPayloads {
+  QString variant;
+  QList<QByteArray> bodies;
+};
+
+static QList<CapturedPayloads>
+load_captured_payloads(const BenchOptions &options) {
+  QList<CapturedPayloads> payloads;
+
+  const QFileInfoList fixtures =
+      QDir(options.fixtures_dir)
+          .entryInfoList({"holyrics-*.json"}, QDir::Files, QDir::Name);
+  for (const QFileInfo &info : fixtures) {
+    QFile file(info.filePath());
+    if (!file.open(QIODevice::ReadOnly))
+      continue;
+    payloads.append({"fixture:" + info.completeBaseName(),
+                     {file.readAll().trimmed()}});
+  }
+  if (fixtures.isEmpty())
+    fprintf(stderr, "Nenhuma fixture em %s\n",
+            qPrintable(options.fixtures_dir));
+
+  for (const QString &path : options.traces) {
+    FeedTraceReader reader;
+    QString error;
+    if (!reader.open(path, &error)) {
+      fprintf(stderr, "Trace %s: %s\n", qPrintable(path), qPrintable(error));
+      continue;
+    }
+    if (reader.client() != TraceClient::Holyrics) {
+      fprintf(stderr, "Trace %s não é do Holyrics, ignorado\n",
+              qPrintable(path));
+      continue;
+    }
+
+    // O gravador só guarda corpos que mudaram: cada um é um slide distinto
+    CapturedPayloads trace{"trace:" + QFileInfo(path).fileName(), {}};
+    FeedTraceRecord record;
+    while (reader.next(record)) {
+      if (record.source == TraceSource::Poll)
+        trace.bodies.append(record.body.toByteArray());
+    }
+    if (!trace.bodies.isEmpty())
+      payloads.append(trace);
+  }
+
+  return payloads;
+}
+
+static void run_captured(const BenchOptions &options) {
+  for (const CapturedPayloads &payload : load_captured_payloads(options)) {
+    qsizetype bytes = 0;
+    int mismatches = 0;
+    for (const QByteArray &body : payload.bodies) {
+      bytes += body.size();
+      if (legacy_detect_holyrics(body) != scanner_detect_holyrics(body))
+        mismatches++;
+    }
+    if (mismatches > 0)
+      fprintf(stderr, "%s: scanner diverge do caminho antigo em %d corpo(s)\n",
+              qPrintable(payload.variant), mismatches);
+
+    // Iterações proporcionais ao tamanho (n é calibrado para ~300 bytes)
+    const int iterations = int(qMax<qint64>(
+        1, qint64(options.micro_iterations) * 300 / qMax<qint64>(300, bytes)));
+    const QByteArray variant = payload.variant.toUtf8();
+
+    QJsonObject legacy = measure_micro(
+        "holyrics_detect_legacy", variant.constData(), iterations, [&]() {
+          bool visible = false;
+          for (const QByteArray &body : payload.bodies)
+            visible ^= legacy_detect_holyrics(body);
+          return visible;
+        });
+    QJsonObject scanner = measure_micro(
+        "holyrics_detect_scanner", variant.constData(), iterations, [&]() {
+          bool visible = false;
+          for (const QByteArray &body : payload.bodies)
+            visible ^= scanner_detect_holyrics(body);
+          return visible;
+        });
+    for (QJsonObject *record : {&legacy, &scanner}) {
+      (*record)["bodies"] = int(payload.bodies.size());
+      (*record)["bytes"] = bytes;
+      (*record)["mismatches"] = mismatches;
+    }
+    emit_record(legacy);
+    emit_record(scanner);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  QCoreApplication app(argc, argv);
+  QCoreApplication::setApplicationName("auto-hide-bench");
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription(
+      "Benchmark fim-a-fim dos clientes Holyrics/ProPresent (JSON Lines)");
+  parser.addHelpOption();
+  QCommandLineOption intervals_option(
+      "intervals", "Intervalos de polling em ms, separados por vírgula.",
+      "lista", "50,100,250,500");
+  QCommandLineOption clients_option(
+      "clients", "Clientes: Holyrics,ProPresent.", "lista",
+      "Holyrics,ProPresent");
+  QCommandLineOption transports_option(
+      "transports", "Transportes: Qt,KeepAlive.", "lista", "Qt,KeepAlive");
+  QCommandLineOption transitions_option(
+      "transitions", "Trocas de slide por cenário.", "n", "20");
+  QCommandLineOption late_option(
+      "late-margin", "Atraso (ms) além do intervalo para contar como tardia.",
+      "ms", "50");
+  QCommandLineOption micro_iterations_option(
+      "micro-iterations", "Iterações dos micro-benchmarks.", "n", "100000");
+  QCommandLineOption no_micro_option("no-micro",
+                                     "Pula os micro-benchmarks.");
+  QCommandLineOption fixtures_option(
+      "fixtures", "Pasta com os corpos de /view/text.json (holyrics-*.json).",
+      "pasta", QStringLiteral(AUTO_HIDE_BENCH_FIXTURES_DIR));
+  QCommandLineOption trace_option(
+      "trace",
+      "Trace .aht do Holyrics gravado pelo plugin: os corpos gravados entram "
+      "nos micro-benchmarks (pode repetir).",
+      "arquivo");
+  QCommandLineOption output_option("output",
+                                   "Arquivo de saída (padrão: stdout).",
+                                   "arquivo");
+  parser.addOptions({intervals_option, clients_option, transports_option,
+                     transitions_option, late_option, micro_iterations_option,
+                     no_micro_option, fixtures_option, trace_option,
+                     output_option});
+  parser.process(app);
+
+  BenchOptions options;
+  options.intervals_ms.clear();
+  for (const QString &value : parser.value(intervals_option).split(',')) {
+    int interval = value.trimmed().toInt();
+    if (interval > 0)
+      options.intervals_ms.append(interval);
+  }
+  options.clients = parser.value(clients_option).split(',');
+  options.transports = parser.value(transports_option).split(',');
+  options.transitions = qMax(1, parser.value(transitions_option).toInt());
+  options.late_margin_ms = parser.value(late_option).toInt();
+  options.micro_iterations =
+      qMax(1, parser.value(micro_iterations_option).toInt());
+  options.run_micro = !parser.isSet(no_micro_option);
+  options.fixtures_dir = parser.value(fixtures_option);
+  options.traces = parser.values(trace_option);
+
+  if (parser.isSet(output_option)) {
+    output_file.setFileName(parser.value(output_option));
+    if (!output_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+      fprintf(stderr, "Não foi possível abrir %s\n",
+              qPrintable(parser.value(output_option)));
+      return 1;
+    }
+  } else if (!output_file.open(stdout, QIODevice::WriteOnly)) {
+    return 1;
+  }
+
+  base_set_log_handler(bench_log_handler, nullptr);
+  PluginLog::set_level(LogLevel::Warning);
+
+  QJsonObject meta;
+  meta["kind"] = "meta";
+  meta["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+  meta["qt_version"] = qVersion();
+  meta["allocation_counter"] = allocation_counter_kind();
+  meta["transitions"] = options.transitions;
+  meta["late_margin_ms"] = options.late_margin_ms;
+  emit_record(meta);
+
+  for (const QString &client : options.clients) {
+    for (const QString &transport : options.transports) {
+      for (int interval : options.intervals_ms) {
+        emit_record(run_scenario(client.trimmed(), transport.trimmed(),
+                                 interval, options));
+      }
+    }
+  }
+
+  if (options.run_micro) {
+    run_micro(options);
+    run_captured(options);
+  }
+
+  return 0;
+}
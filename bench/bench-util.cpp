@@ -0,0 +1,114 @@
+#include "bench-util.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+static std::atomic<uint64_t> allocations{0};
+static thread_local bool tracking_enabled = true;
+
+static inline void count_allocation() {
+  if (tracking_enabled)
+    allocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t allocation_count() {
+  return allocations.load(std::memory_order_relaxed);
+}
+
+void set_thread_allocation_tracking(bool enabled) { tracking_enabled = enabled; }
+
+#if defined(__GLIBC__)
+
+// Interposição de malloc: o executável exporta os símbolos e o loader os
+// usa também para Qt/libobs. As versões __libc_* são públicas na glibc.
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size) noexcept {
+  count_allocation();
+  return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) noexcept {
+  count_allocation();
+  return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) noexcept {
+  count_allocation();
+  return __libc_realloc(ptr, size);
+}
+}
+
+const char *allocation_counter_kind() { return "malloc"; }
+
+#else
+
+void *operator new(size_t size) {
+  count_allocation();
+  if (void *ptr = std::malloc(size ? size : 1))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void *operator new[](size_t size) {
+  count_allocation();
+  if (void *ptr = std::malloc(size ? size : 1))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { std::free(ptr); }
+
+const char *allocation_counter_kind() { return "operator new"; }
+
+#endif
+
+#ifdef _WIN32
+
+static uint64_t filetime_ns(const FILETIME &time) {
+  ULARGE_INTEGER value;
+  value.LowPart = time.dwLowDateTime;
+  value.HighPart = time.dwHighDateTime;
+  return value.QuadPart * 100;
+}
+
+uint64_t thread_cpu_ns() {
+  FILETIME creation, exit, kernel, user;
+  if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user))
+    return 0;
+  return filetime_ns(kernel) + filetime_ns(user);
+}
+
+uint64_t process_cpu_ns() {
+  FILETIME creation, exit, kernel, user;
+  if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+    return 0;
+  return filetime_ns(kernel) + filetime_ns(user);
+}
+
+#else
+
+static uint64_t clock_ns(clockid_t clock) {
+  struct timespec ts;
+  if (clock_gettime(clock, &ts) != 0)
+    return 0;
+  return uint64_t(ts.tv_sec) * 1000000000ULL + uint64_t(ts.tv_nsec);
+}
+
+uint64_t thread_cpu_ns() { return clock_ns(CLOCK_THREAD_CPUTIME_ID); }
+
+uint64_t process_cpu_ns() { return clock_ns(CLOCK_PROCESS_CPUTIME_ID); }
+
+#endif
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+
+// Tempo de CPU da thread atual / do processo inteiro, em ns
+uint64_t thread_cpu_ns();
+uint64_t process_cpu_ns();
+
+// Alocações de memória feitas pelas threads rastreadas (todas, por padrão).
+// Em glibc conta malloc/calloc/realloc (pega também QByteArray/QString);
+// nas outras plataformas conta só operator new.
+uint64_t allocation_count();
+// Desliga a contagem para a thread atual (ex: thread do servidor falso)
+void set_thread_allocation_tracking(bool enabled);
+// "malloc" ou "operator new": o que allocation_count() enxerga
+const char *allocation_counter_kind();
@@ -0,0 +1,284 @@
+#include "mock-server.hpp"
+#include "bench-util.hpp"
+#include <QHostAddress>
+
+// Tamanho parecido com o de /view/text.json de um Holyrics real
+QByteArray MockPresentationServer::holyrics_body_for(bool visible,
+                                                     int variant) {
+  QByteArray type = "BIBLE";
+  QByteArray text;
+  if (visible) {
+    text = "<p style=\\\"text-align: center;\\\">No princ\\u00edpio era o "
+           "Verbo, e o Verbo estava com Deus, e o Verbo era Deus.</p>";
+  } else if (variant % 2 == 0) {
+    // Tela limpa (F9): BIBLE com texto só de tags/espaços
+    text = "<p>&nbsp;</p><br/>";
+  } else {
+    type = "TEXT";
+    text = "<p>Avisos da semana</p>";
+  }
+
+  return "{\"status\":\"ok\",\"map\":{\"type\":\"" + type +
+         "\",\"text\":\"" + text +
+         "\",\"header\":\"Jo\\u00e3o 1:1\",\"theme\":\"default\","
+         "\"slide_number\":1,\"total_slides\":3,\"show\":true}}";
+}
+
+QByteArray MockPresentationServer::propresent_body_for(bool visible) {
+  if (!visible)
+    return "{\"presentation\":null}";
+
+  return "{\"presentation\":{\"id\":{\"uuid\":"
+         "\"5C1E2B1A-0D7F-4C5B-9A61-7E2D3F4A5B6C\",\"name\":\"Culto de "
+         "Domingo\",\"index\":3},\"groups\":[{\"name\":\"Verso 1\","
+         "\"color\":{\"red\":0,\"green\":0.46,\"blue\":0.8,\"alpha\":1},"
+         "\"slides\":[{\"enabled\":true,\"notes\":\"\",\"text\":\"No "
+         "princ\\u00edpio era o Verbo\",\"label\":\"\"}]}],"
+         "\"has_timeline\":false,\"presentation_path\":\"\"}}";
+}
+
+MockPresentationServer::MockPresentationServer(QObject *parent)
+    : QObject(parent) {
+  set_verse(false);
+}
+
+MockPresentationServer::~MockPresentationServer() { stop(); }
+
+bool MockPresentationServer::start() {
+  if (server_thread)
+    return listen_port != 0;
+
+  server_thread = new QThread();
+  server_thread->setObjectName("mock-server");
+  server_thread->start();
+
+  server = new QTcpServer();
+  server->moveToThread(server_thread);
+  QMetaObject::invokeMethod(
+      server, [this]() { listen(); }, Qt::BlockingQueuedConnection);
+  return listen_port != 0;
+}
+
+void MockPresentationServer::stop() {
+  if (!server_thread)
+    return;
+
+  QMetaObject::invokeMethod(
+      server,
+      [this]() {
+        for (QTcpSocket *socket : pending.keys()) {
+          QObject::disconnect(socket, nullptr, server, nullptr);
+          socket->abort();
+        }
+        pending.clear();
+        streams.clear();
+        stream_count = 0;
+        // Sockets são filhos do QTcpServer
+        delete server;
+        server = nullptr;
+      },
+      Qt::BlockingQueuedConnection);
+
+  server_thread->quit();
+  server_thread->wait();
+  delete server_thread;
+  server_thread = nullptr;
+  listen_port = 0;
+}
+
+void MockPresentationServer::set_verse(bool visible, int variant) {
+  QByteArray holyrics = holyrics_body_for(visible, variant);
+  QByteArray propresent = propresent_body_for(visible);
+
+  {
+    std::lock_guard<std::mutex> lock(content_mutex);
+    holyrics_body = holyrics;
+    propresent_body = propresent;
+    version++;
+    etag = "\"" + QByteArray::number(version) + "\"";
+  }
+
+  if (server_thread)
+    QMetaObject::invokeMethod(
+        server, [this]() { push_to_streams(); }, Qt::QueuedConnection);
+}
+
+void MockPresentationServer::set_holyrics_stream(const QByteArray &path,
+                                                 MockStreamFormat format) {
+  std::lock_guard<std::mutex> lock(content_mutex);
+  holyrics_stream_path = path;
+  holyrics_stream_format = format;
+}
+
+void MockPresentationServer::drop_streams() {
+  if (!server_thread)
+    return;
+
+  QMetaObject::invokeMethod(
+      server,
+      [this]() {
+        const QList<QTcpSocket *> sockets = streams.keys();
+        streams.clear();
+        stream_count = 0;
+        for (QTcpSocket *socket : sockets) {
+          // Fim do corpo chunked: o cliente vê o stream encerrado
+          socket->write("0\r\n\r\n");
+          socket->disconnectFromHost();
+        }
+      },
+      Qt::BlockingQueuedConnection);
+}
+
+void MockPresentationServer::listen() {
+  // Alocações do servidor não entram na conta do cliente
+  set_thread_allocation_tracking(false);
+
+  QObject::connect(server, &QTcpServer::newConnection, server,
+                   [this]() { on_new_connection(); });
+  if (server->listen(QHostAddress::LocalHost, 0))
+    listen_port = server->serverPort();
+}
+
+void MockPresentationServer::on_new_connection() {
+  while (server->hasPendingConnections()) {
+    QTcpSocket *socket = server->nextPendingConnection();
+    socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    pending.insert(socket, QByteArray());
+
+    QObject::connect(socket, &QTcpSocket::readyRead, server,
+                     [this, socket]() { on_ready_read(socket); });
+    QObject::connect(socket, &QTcpSocket::disconnected, server,
+                     [this, socket]() {
+                       pending.remove(socket);
+                       if (streams.remove(socket))
+                         stream_count--;
+                       socket->deleteLater();
+                     });
+  }
+}
+
+void MockPresentationServer::on_ready_read(QTcpSocket *socket) {
+  const quint64 cpu_start = thread_cpu_ns();
+
+  QByteArray &buffer = pending[socket];
+  buffer += socket->readAll();
+
+  while (true) {
+    qsizetype end = buffer.indexOf("\r\n\r\n");
+    if (end < 0)
+      break;
+
+    QByteArray head = buffer.left(end);
+
+    // "GET /caminho HTTP/1.1"
+    QList<QByteArray> lines = head.split('\n');
+    QList<QByteArray> request_line = lines.value(0).trimmed().split(' ');
+    QByteArray path = request_line.value(1);
+    qsizetype query = path.indexOf('?');
+    if (query >= 0)
+      path.truncate(query);
+
+    QByteArray if_none_match;
+    qsizetype content_length = 0;
+    for (qsizetype i = 1; i < lines.size(); i++) {
+      QByteArray line = lines[i].trimmed();
+      const QByteArray name = line.toLower();
+      if (name.startsWith("if-none-match:"))
+        if_none_match = line.mid(14).trimmed();
+      else if (name.startsWith("content-length:"))
+        content_length = line.mid(15).trimmed().toLongLong();
+    }
+
+    // Corpo do POST (tópicos do stream do ProPresenter): só é descartado
+    if (buffer.size() < end + 4 + content_length)
+      break;
+    buffer.remove(0, end + 4 + content_length);
+
+    request_count++;
+    if (open_stream(socket, path))
+      continue;
+    socket->write(respond(path, if_none_match));
+  }
+
+  handler_cpu_ns += thread_cpu_ns() - cpu_start;
+}
+
+QByteArray MockPresentationServer::respond(const QByteArray &path,
+                                           const QByteArray &if_none_match) {
+  QByteArray body;
+  QByteArray current_etag;
+  {
+    std::lock_guard<std::mutex> lock(content_mutex);
+    if (path == "/view/text.json") {
+      body = holyrics_body;
+    } else if (path == "/v1/presentation/active") {
+      body = propresent_body;
+    } else {
+      return "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n";
+    }
+    current_etag = etag;
+  }
+
+  if (!if_none_match.isEmpty() && if_none_match == current_etag) {
+    return "HTTP/1.1 304 Not Modified\r\nETag: " + current_etag +
+           "\r\nContent-Length: 0\r\n\r\n";
+  }
+
+  return "HTTP/1.1 200 OK\r\n"
+         "Content-Type: application/json; charset=utf-8\r\n"
+         "ETag: " + current_etag + "\r\n"
+         "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+         "Connection: keep-alive\r\n\r\n" + body;
+}
+
+bool MockPresentationServer::open_stream(QTcpSocket *socket,
+                                         const QByteArray &path) {
+  StreamKind kind;
+  {
+    std::lock_guard<std::mutex> lock(content_mutex);
+    if (path == "/v1/status/updates")
+      kind = StreamKind::ProPresent;
+    else if (!holyrics_stream_path.isEmpty() && path == holyrics_stream_path)
+      kind = StreamKind::Holyrics;
+    else
+      return false;
+  }
+
+  const QByteArray content_type =
+      kind == StreamKind::Holyrics &&
+              holyrics_stream_format == MockStreamFormat::Sse
+          ? "text/event-stream"
+          : "application/json";
+  socket->write("HTTP/1.1 200 OK\r\n"
+                "Content-Type: " + content_type + "\r\n"
+                "Transfer-Encoding: chunked\r\n"
+                "Cache-Control: no-cache\r\n\r\n");
+
+  streams.insert(socket, kind);
+  stream_count++;
+
+  // Estado atual logo na abertura, como os servidores reais
+  const QByteArray message = stream_message(kind);
+  socket->write(QByteArray::number(message.size(), 16) + "\r\n" + message +
+                "\r\n");
+  return true;
+}
+
+QByteArray MockPresentationServer::stream_message(StreamKind kind) const {
+  std::lock_guard<std::mutex> lock(content_mutex);
+  if (kind == StreamKind::ProPresent)
+    return "{\"url\":\"presentation/active\",\"data\":" + propresent_body +
+           "}\r\n";
+
+  if (holyrics_stream_format == MockStreamFormat::Sse)
+    return "data: " + holyrics_body + "\n\n";
+  return holyrics_body + "\n";
+}
+
+void MockPresentationServer::push_to_streams() {
+  for (auto it = streams.cbegin(); it != streams.cend(); ++it) {
+    const QByteArray message = stream_message(it.value());
+    it.key()->write(QByteArray::number(message.size(), 16) + "\r\n" +
+                    message + "\r\n");
+  }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThread>
+#include <atomic>
+#include <mutex>
+
+// Formato do stream do Holyrics no servidor falso
+enum class MockStreamFormat {
+  ChunkedJson, // Um objeto JSON por linha
+  Sse          // "data: {...}" + linha em branco
+};
+
+// Servidor HTTP/1.1 falso, em processo, que fala /view/text.json (Holyrics)
+// e /v1/presentation/active (ProPresenter). Roda na própria thread; o
+// benchmark troca o slide com set_verse() a partir da thread principal.
+// Responde com ETag e 304 para If-None-Match igual, como o Holyrics real.
+//
+// Push: /v1/status/updates (ProPresenter) e o caminho dado em
+// set_holyrics_stream() ficam abertos com Transfer-Encoding: chunked; cada
+// set_verse() vira uma mensagem, e drop_streams() derruba as conexões.
+class MockPresentationServer : public QObject {
+  Q_OBJECT
+
+public:
+  explicit MockPresentationServer(QObject *parent = nullptr);
+  ~MockPresentationServer() override;
+
+  // Sobe a thread do servidor e escuta em 127.0.0.1 (porta livre)
+  bool start();
+  void stop();
+  quint16 port() const { return listen_port; }
+
+  // Troca o conteúdo servido. variant alterna entre as formas de "sem
+  // versículo" (Holyrics: BIBLE em branco / outro tipo). Thread-safe.
+  void set_verse(bool visible, int variant = 0);
+
+  // Caminho e formato do stream do Holyrics (vazio = sem stream)
+  void set_holyrics_stream(const QByteArray &path, MockStreamFormat format);
+  // Encerra os streams abertos, como uma queda do servidor
+  void drop_streams();
+
+  // Corpos servidos para cada estado (também usados nos micro-benchmarks)
+  static QByteArray holyrics_body_for(bool visible, int variant);
+  static QByteArray propresent_body_for(bool visible);
+
+  // Contadores (thread-safe)
+  quint64 requests() const { return request_count; }
+  // Streams abertos no momento
+  int open_streams() const { return stream_count; }
+  // Tempo de CPU gasto pela thread do servidor tratando requisições
+  quint64 cpu_ns() const { return handler_cpu_ns; }
+
+private:
+  QThread *server_thread = nullptr;
+  QTcpServer *server = nullptr;
+  quint16 listen_port = 0;
+  QHash<QTcpSocket *, QByteArray> pending;
+
+  enum class StreamKind { ProPresent, Holyrics };
+  QHash<QTcpSocket *, StreamKind> streams; // Só na thread do servidor
+
+  mutable std::mutex content_mutex;
+  QByteArray holyrics_body;
+  QByteArray propresent_body;
+  QByteArray etag;
+  quint64 version = 0;
+  QByteArray holyrics_stream_path;
+  MockStreamFormat holyrics_stream_format = MockStreamFormat::ChunkedJson;
+
+  std::atomic<quint64> request_count{0};
+  std::atomic<quint64> handler_cpu_ns{0};
+  std::atomic<int> stream_count{0};
+
+  void listen();
+  void on_new_connection();
+  void on_ready_read(QTcpSocket *socket);
+  QByteArray respond(const QByteArray &path, const QByteArray &if_none_match);
+  bool open_stream(QTcpSocket *socket, const QByteArray &path);
+  QByteArray stream_message(StreamKind kind) const;
+  void push_to_streams();
+};
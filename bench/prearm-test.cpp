@@ -0,0 +1,120 @@
+// Teste do desarme do hide pré-armado (roda no CTest).
+//
+// Sequência do review: o próximo item anuncia um versículo (prepara), o
+// versículo entra no ar e, antes de o filtro confirmar, o próximo item
+// passa a ser outro (upcoming = false). A preparação só pode ser desfeita
+// quando o filtro assentar em "sem versículo".
+//
+// Sai com código != 0 se alguma verificação falhar.
+
+#include "prearm-gate.hpp"
+#include "verse-filter.hpp"
+
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QTimer>
+#include <cstdio>
+
+static constexpr int kHideConfirmMs = 150;
+static constexpr int kShowConfirmMs = 300;
+
+static int failures = 0;
+
+static void check(bool condition, const char *scenario, const char *what) {
+  fprintf(stderr, "%s: %s: %s\n", condition ? "ok" : "FALHOU", scenario,
+          what);
+  if (!condition)
+    failures++;
+}
+
+static void sleep_in_loop(int ms) {
+  QEventLoop loop;
+  QTimer::singleShot(ms, &loop, &QEventLoop::quit);
+  loop.exec();
+}
+
+struct Fixture {
+  VerseStateFilter filter;
+  PrearmGate gate{filter};
+  int arms = 0;
+  int disarms = 0;
+
+  Fixture() {
+    filter.set_timing(kHideConfirmMs, kShowConfirmMs, 0);
+    filter.on_stats_changed = [this](const VerseFilterStats &) {
+      gate.filter_changed();
+    };
+    gate.on_arm = [this]() { arms++; };
+    gate.on_disarm = [this]() { disarms++; };
+  }
+};
+
+static void verse_goes_live() {
+  const char *name = "versículo previsto entra no ar";
+  Fixture f;
+
+  f.gate.set_upcoming(true);
+  check(f.arms == 1, name, "preparado pelo próximo item");
+
+  f.filter.submit(true, TransitionTrace());
+  f.gate.set_upcoming(false);
+  check(f.disarms == 0, name, "mantido com o versículo pendente");
+
+  sleep_in_loop(kHideConfirmMs + 100);
+  check(f.filter.state(), name, "filtro confirmou o versículo");
+  check(f.disarms == 0, name, "mantido com o versículo na tela");
+
+  f.filter.submit(false, TransitionTrace());
+  check(f.disarms == 0, name, "mantido enquanto o fim não é confirmado");
+  sleep_in_loop(kShowConfirmMs + 100);
+  check(f.disarms == 1, name, "desfeito quando o filtro assenta");
+}
+
+static void verse_flickers() {
+  const char *name = "versículo descartado como piscada";
+  Fixture f;
+
+  f.gate.set_upcoming(true);
+  f.filter.submit(true, TransitionTrace());
+  f.gate.set_upcoming(false);
+  f.filter.submit(false, TransitionTrace());
+  check(f.disarms == 1, name, "desfeito quando a mudança é descartada");
+}
+
+static void no_verse() {
+  const char *name = "sem versículo";
+  Fixture f;
+
+  f.gate.set_upcoming(true);
+  f.gate.set_upcoming(false);
+  check(f.disarms == 1, name, "desfeito na hora");
+}
+
+static void upcoming_again() {
+  const char *name = "próximo item volta a ser versículo";
+  Fixture f;
+
+  f.gate.set_upcoming(true);
+  f.filter.submit(true, TransitionTrace());
+  f.gate.set_upcoming(false);
+  f.gate.set_upcoming(true);
+  check(f.arms == 2, name, "preparado de novo");
+  check(!f.gate.is_release_pending(), name, "desarme pendente esquecido");
+
+  sleep_in_loop(kHideConfirmMs + 100);
+  f.filter.submit(false, TransitionTrace());
+  sleep_in_loop(kShowConfirmMs + 100);
+  check(f.disarms == 0, name, "preparação mantida");
+}
+
+int main(int argc, char *argv[]) {
+  QCoreApplication app(argc, argv);
+
+  verse_goes_live();
+  verse_flickers();
+  no_verse();
+  upcoming_again();
+
+  fprintf(stderr, "%d verificação(ões) falharam\n", failures);
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,184 @@
+// Reprodução offline de um trace do feed (.aht) gravado pelo plugin.
+//
+// Mapeia o arquivo em memória e entrega cada corpo gravado ao cliente real
+// (detect_verse + máquina de estados), no tempo gravado ou acelerado.
+// Imprime em JSON Lines cada transição detectada e um resumo com o custo
+// da detecção, para comparar versões do detector no mesmo culto.
+
+#include "bench-util.hpp"
+
+#include "feed-trace.hpp"
+#include "holyrics-client.hpp"
+#include "plugin-log.hpp"
+#include "propresent-client.hpp"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+#include <cstdio>
+#include <util/base.h>
+
+static QFile output_file;
+
+static void emit_record(const QJsonObject &record) {
+  output_file.write(QJsonDocument(record).toJson(QJsonDocument::Compact));
+  output_file.write("\n");
+}
+
+static void replay_log_handler(int level, const char *format, va_list args,
+                               void *) {
+  if (level > LOG_WARNING)
+    return;
+  vfprintf(stderr, format, args);
+  fputc('\n', stderr);
+}
+
+int main(int argc, char *argv[]) {
+  QCoreApplication app(argc, argv);
+  QCoreApplication::setApplicationName("auto-hide-replay");
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription(
+      "Reproduz um trace .aht nos clientes Holyrics/ProPresent (JSON Lines)");
+  parser.addHelpOption();
+  parser.addPositionalArgument("trace", "Arquivo .aht gravado pelo plugin.");
+  QCommandLineOption speed_option(
+      "speed",
+      "Velocidade: 1 = tempo gravado, 10 = 10x mais rápido, "
+      "0 = sem esperas (padrão).",
+      "fator", "0");
+  QCommandLineOption repeat_option(
+      "repeat", "Repete o trace N vezes (para profiling).", "n", "1");
+  QCommandLineOption quiet_option("quiet",
+                                  "Não imprime cada transição, só o resumo.");
+  QCommandLineOption output_option("output",
+                                   "Arquivo de saída (padrão: stdout).",
+                                   "arquivo");
+  parser.addOptions({speed_option, repeat_option, quiet_option, output_option});
+  parser.process(app);
+
+  const QStringList positional = parser.positionalArguments();
+  if (positional.size() != 1)
+    parser.showHelp(1);
+
+  const double speed = qMax(0.0, parser.value(speed_option).toDouble());
+  const int repeat = qMax(1, parser.value(repeat_option).toInt());
+  const bool quiet = parser.isSet(quiet_option);
+
+  if (parser.isSet(output_option)) {
+    output_file.setFileName(parser.value(output_option));
+    if (!output_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+      fprintf(stderr, "Não foi possível abrir %s\n",
+              qPrintable(parser.value(output_option)));
+      return 1;
+    }
+  } else if (!output_file.open(stdout, QIODevice::WriteOnly)) {
+    return 1;
+  }
+
+  base_set_log_handler(replay_log_handler, nullptr);
+  PluginLog::set_level(LogLevel::Warning);
+
+  FeedTraceReader reader;
+  QString error;
+  if (!reader.open(positional.first(), &error)) {
+    fprintf(stderr, "%s: %s\n", qPrintable(positional.first()),
+            qPrintable(error));
+    return 1;
+  }
+
+  HolyricsClient *holyrics = nullptr;
+  ProPresentClient *propresent = nullptr;
+  IPresentationClient *client = nullptr;
+  if (reader.client() == TraceClient::ProPresent) {
+    propresent = new ProPresentClient();
+    client = propresent;
+  } else {
+    holyrics = new HolyricsClient();
+    client = holyrics;
+  }
+
+  uint64_t current_timestamp_ns = 0;
+  int pass = 0;
+  quint64 transitions = 0;
+  client->on_verse_changed = [&](bool visible, const TransitionTrace &) {
+    transitions++;
+    if (quiet)
+      return;
+    QJsonObject record;
+    record["kind"] = "transition";
+    record["pass"] = pass;
+    record["t_ms"] = current_timestamp_ns / 1000000.0;
+    record["visible"] = visible;
+    emit_record(record);
+  };
+
+  quint64 records = 0;
+  uint64_t recorded_ns = 0;
+  qint64 detect_total_ns = 0;
+  qint64 detect_max_ns = 0;
+  const uint64_t allocations_start = allocation_count();
+  QElapsedTimer wall;
+  wall.start();
+
+  for (pass = 0; pass < repeat; pass++) {
+    reader.rewind();
+    QElapsedTimer pass_clock;
+    pass_clock.start();
+
+    FeedTraceRecord record;
+    while (reader.next(record)) {
+      current_timestamp_ns = record.timestamp_ns;
+      recorded_ns = qMax(recorded_ns, record.timestamp_ns);
+
+      if (speed > 0) {
+        // Espera até o momento gravado (escalado pela velocidade)
+        const qint64 due_ns = qint64(record.timestamp_ns / speed);
+        const qint64 wait_ns = due_ns - pass_clock.nsecsElapsed();
+        if (wait_ns > 0)
+          QThread::usleep(static_cast<unsigned long>(wait_ns / 1000));
+      }
+
+      // Sem cópia: o corpo continua no arquivo mapeado
+      const QByteArray body =
+          QByteArray::fromRawData(record.body.data(), record.body.size());
+
+      QElapsedTimer detect_clock;
+      detect_clock.start();
+      if (holyrics)
+        holyrics->feed_recorded(record.source, body);
+      else
+        propresent->feed_recorded(record.source, body);
+      const qint64 detect_ns = detect_clock.nsecsElapsed();
+
+      detect_total_ns += detect_ns;
+      detect_max_ns = qMax(detect_max_ns, detect_ns);
+      records++;
+    }
+  }
+
+  const uint64_t allocations = allocation_count() - allocations_start;
+
+  QJsonObject summary;
+  summary["kind"] = "summary";
+  summary["trace"] = positional.first();
+  summary["client"] = holyrics ? "Holyrics" : "ProPresent";
+  summary["passes"] = repeat;
+  summary["records"] = double(records);
+  summary["transitions"] = double(transitions);
+  summary["recorded_ms"] = recorded_ns / 1000000.0;
+  summary["wall_ms"] = double(wall.elapsed());
+  summary["detect_ns_avg"] = records ? double(detect_total_ns) / records : 0.0;
+  summary["detect_ns_max"] = double(detect_max_ns);
+  summary["allocations_per_record"] =
+      records ? double(allocations) / records : 0.0;
+  summary["allocation_counter"] = allocation_counter_kind();
+  emit_record(summary);
+
+  delete client;
+  return 0;
+}
@@ -0,0 +1,155 @@
+// Teste do modo push contra o servidor falso (roda no CTest).
+//
+// Para cada stream (ProPresenter em /v1/status/updates; Holyrics em SSE e
+// em JSON chunked num caminho configurado) verifica que:
+//   - com o stream aberto o polling para e a troca de slide chega ao
+//     on_verse_changed pelo stream;
+//   - quando o servidor derruba o stream, o cliente volta ao polling e
+//     continua detectando as trocas.
+//
+// Sai com código != 0 se alguma verificação falhar.
+
+#include "mock-server.hpp"
+
+#include "holyrics-client.hpp"
+#include "propresent-client.hpp"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QTimer>
+#include <cstdio>
+#include <functional>
+
+static constexpr int kPollIntervalMs = 100;
+// Bem abaixo do kStreamRetryMs dos clientes (5 s): a fase de fallback
+// termina antes de o stream ser reaberto
+static constexpr int kTimeoutMs = 2000;
+
+static int failures = 0;
+
+static bool check(bool condition, const char *scenario, const char *what) {
+  fprintf(stderr, "%s: %s: %s\n", condition ? "ok" : "FALHOU", scenario,
+          what);
+  if (!condition)
+    failures++;
+  return condition;
+}
+
+// Roda o event loop até a condição valer (ou o tempo acabar)
+static bool wait_until(const std::function<bool()> &condition, int timeout_ms) {
+  QElapsedTimer elapsed;
+  elapsed.start();
+  while (!condition()) {
+    if (elapsed.elapsed() >= timeout_ms)
+      return false;
+    QEventLoop loop;
+    QTimer::singleShot(10, &loop, &QEventLoop::quit);
+    loop.exec();
+  }
+  return true;
+}
+
+static void sleep_in_loop(int ms) {
+  QEventLoop loop;
+  QTimer::singleShot(ms, &loop, &QEventLoop::quit);
+  loop.exec();
+}
+
+// Cliente + acesso aos contadores de polling (não fazem parte da interface)
+struct StreamScenario {
+  const char *name;
+  IPresentationClient *client;
+  std::function<quint64()> poll_requests;
+};
+
+static void run_scenario(MockPresentationServer &server,
+                         const StreamScenario &scenario) {
+  const char *name = scenario.name;
+  IPresentationClient *client = scenario.client;
+
+  bool visible = false;
+  int changes = 0;
+  client->on_verse_changed = [&](bool state, const TransitionTrace &) {
+    visible = state;
+    changes++;
+  };
+
+  server.set_verse(false);
+  client->connect(QString("http://127.0.0.1:%1").arg(server.port()));
+
+  if (!check(wait_until([&]() { return server.open_streams() > 0; },
+                        kTimeoutMs),
+             name, "stream aberto")) {
+    client->disconnect();
+    return;
+  }
+
+  // O stream confirma no primeiro byte: a partir daí o polling para
+  sleep_in_loop(3 * kPollIntervalMs);
+  const quint64 requests_streaming = scenario.poll_requests();
+  server.set_verse(true);
+  check(wait_until([&]() { return visible; }, kTimeoutMs), name,
+        "versículo detectado pelo stream");
+  sleep_in_loop(3 * kPollIntervalMs);
+  check(scenario.poll_requests() == requests_streaming, name,
+        "sem polling com o stream ativo");
+
+  // Queda do stream: volta ao polling até a próxima tentativa
+  const int changes_before_drop = changes;
+  server.drop_streams();
+  check(wait_until(
+            [&]() { return scenario.poll_requests() > requests_streaming; },
+            kTimeoutMs),
+        name, "polling retomado após a queda");
+  server.set_verse(false);
+  check(wait_until([&]() { return !visible; }, kTimeoutMs), name,
+        "fim do versículo detectado pelo polling");
+  check(changes == changes_before_drop + 1, name,
+        "uma única mudança por troca de slide");
+
+  client->disconnect();
+  client->on_verse_changed = nullptr;
+}
+
+int main(int argc, char *argv[]) {
+  QCoreApplication app(argc, argv);
+
+  MockPresentationServer server;
+  if (!server.start()) {
+    fprintf(stderr, "FALHOU: servidor falso não subiu\n");
+    return 1;
+  }
+
+  {
+    ProPresentClient client;
+    client.set_polling_interval(kPollIntervalMs);
+    client.set_push_mode(true);
+    run_scenario(server, {"ProPresenter /v1/status/updates", &client,
+                          [&]() { return client.poll_stats().requests; }});
+  }
+
+  const struct {
+    const char *name;
+    const char *path;
+    MockStreamFormat format;
+  } holyrics_streams[] = {
+      {"Holyrics SSE", "/api/stream/sse", MockStreamFormat::Sse},
+      {"Holyrics JSON chunked", "/api/stream/json",
+       MockStreamFormat::ChunkedJson},
+  };
+
+  for (const auto &stream : holyrics_streams) {
+    server.set_holyrics_stream(stream.path, stream.format);
+    HolyricsClient client;
+    client.set_polling_interval(kPollIntervalMs);
+    client.set_stream_path(stream.path);
+    client.set_push_mode(true);
+    run_scenario(server, {stream.name, &client,
+                          [&]() { return client.poll_stats().requests; }});
+  }
+
+  server.stop();
+  fprintf(stderr, "%d verificação(ões) falharam\n", failures);
+  return failures == 0 ? 0 : 1;
+}
@@ -21,8 +21,7 @@ void AutoHideDockWidget::setup_ui() {
   QVBoxLayout *main_layout = new QVBoxLayout(this);
 
   // Header Status
-  QString softwareName = config.client_type;
-  connection_status_label = new QLabel("● " + softwareName + ": Desconectado", this);
+  connection_status_label = new QLabel("● " + clients_name() + ": Desconectado", this);
   main_layout->addWidget(connection_status_label);
 
   // Main Toggle Button
@@ -41,6 +40,11 @@ void AutoHideDockWidget::setup_ui() {
   last_event_label = new QLabel("", this);
   main_layout->addWidget(last_event_label);
 
+  filter_label = new QLabel("", this);
+  filter_label->setStyleSheet("QLabel { color: #888; font-size: 11px; }");
+  filter_label->setVisible(false);
+  main_layout->addWidget(filter_label);
+
   // Sources Info
   sources_group = new QGroupBox("Escondendo quando versículo:", this);
   QVBoxLayout *sources_layout = new QVBoxLayout(sources_group);
@@ -50,6 +54,15 @@ void AutoHideDockWidget::setup_ui() {
   sources_group->setVisible(false);
   main_layout->addWidget(sources_group);
 
+  // Latência (slide -> fonte), preenchida após a primeira transição
+  latency_group = new QGroupBox("Latência (desde a consulta):", this);
+  QVBoxLayout *latency_layout = new QVBoxLayout(latency_group);
+  latency_label = new QLabel("", this);
+  latency_label->setStyleSheet("QLabel { font-family: monospace; font-size: 11px; }");
+  latency_layout->addWidget(latency_label);
+  latency_group->setVisible(false);
+  main_layout->addWidget(latency_group);
+
   main_layout->addStretch();
 
   // Settings Button
@@ -60,7 +73,7 @@ void AutoHideDockWidget::setup_ui() {
           &AutoHideDockWidget::open_settings);
 
   // Client Info
-  client_info_label = new QLabel("Cliente Atual: " + config.client_type, this);
+  client_info_label = new QLabel("Cliente Atual: " + clients_name(), this);
   client_info_label->setAlignment(Qt::AlignCenter);
   client_info_label->setMinimumHeight(20); // Forçar altura mínima
   client_info_label->setStyleSheet("QLabel { color: #888; font-size: 11px; margin-top: 10px; font-weight: bold; }");
@@ -68,7 +81,10 @@ void AutoHideDockWidget::setup_ui() {
 }
 
 void AutoHideDockWidget::update_ui_state() {
-  client_info_label->setText("Cliente Atual: " + config.client_type);
+  QString client_info = "Cliente Atual: " + clients_name();
+  if (config.holyrics_push_inactive())
+    client_info += " (push inativo: sem caminho de stream)";
+  client_info_label->setText(client_info);
 
   if (plugin_active) {
     // Estilo ATIVO (Vermelho para parar)
@@ -86,7 +102,6 @@ void AutoHideDockWidget::update_ui_state() {
     status_label->setText("Status: ✅ Ativo - Monitorando");
     sources_group->setVisible(true);
     update_sources_list();
-    connection_status_label->setText("🟢 " + config.client_type + ": Conectado");
   } else {
     // Estilo INATIVO (Verde para iniciar)
     toggle_button->setText("ATIVAR PLUGIN");
@@ -103,8 +118,15 @@ void AutoHideDockWidget::update_ui_state() {
     status_label->setText("Status: ⚪ Desativado");
     sources_group->setVisible(false);
     last_event_label->setText("");
-    connection_status_label->setText("● " + config.client_type + ": Desconectado");
   }
+  render_connection_status();
+}
+
+QString AutoHideDockWidget::clients_name() const {
+  QStringList types(config.client_type);
+  for (const ClientEndpoint &endpoint : config.extra_clients)
+    types.append(endpoint.type);
+  return types.join(" + ");
 }
 
 void AutoHideDockWidget::update_sources_list() {
@@ -132,6 +154,9 @@ void AutoHideDockWidget::set_active(bool active, bool restore_state) {
     }
 
     plugin_active = true;
+    // Clientes recomeçam do zero: "Conectando..." até a primeira resposta
+    connection_state = ConnectionState::Connected;
+    server_answered = false;
     if (*active_client_ptr) {
         (*active_client_ptr)->connect(config.holyrics_url);
     }
@@ -140,9 +165,13 @@ void AutoHideDockWidget::set_active(bool active, bool restore_state) {
     if (*active_client_ptr) {
         (*active_client_ptr)->disconnect();
     }
-    if (restore_state) {
-        scene_controller->restore_previous_state();
-    }
+  }
+  // Antes de restaurar: a desativação cancela as ações ainda pendentes
+  if (on_activation_changed) {
+      on_activation_changed(plugin_active);
+  }
+  if (!plugin_active && restore_state) {
+      scene_controller->restore_previous_state();
   }
   update_ui_state();
 }
@@ -175,10 +204,107 @@ void AutoHideDockWidget::update_last_event(bool verse_visible) {
   }
 }
 
-void AutoHideDockWidget::update_connection_status(bool connected) {
-  if (connected) {
-    connection_status_label->setText("🟢 " + config.client_type + ": Conectado");
-  } else {
-    connection_status_label->setText("🔴 " + config.client_type + ": Sem conexão");
+void AutoHideDockWidget::update_connection_status(ConnectionState state) {
+  connection_state = state;
+  render_connection_status();
+}
+
+void AutoHideDockWidget::update_reachability(bool reachable) {
+  // Só a primeira resposta importa: as quedas chegam pelo circuit breaker
+  if (reachable)
+    server_answered = true;
+  render_connection_status();
+}
+
+void AutoHideDockWidget::reset_connection_status() {
+  connection_state = ConnectionState::Connected;
+  server_answered = false;
+  render_connection_status();
+}
+
+void AutoHideDockWidget::render_connection_status() {
+  const QString name = clients_name();
+
+  // Desativado: o rótulo fica em "Desconectado"
+  if (!plugin_active) {
+    connection_status_label->setText("● " + name + ": Desconectado");
+    return;
   }
+
+  switch (connection_state) {
+  case ConnectionState::Connected:
+    if (server_answered)
+      connection_status_label->setText("🟢 " + name + ": Conectado");
+    else
+      connection_status_label->setText("⚪ " + name + ": Conectando...");
+    break;
+  case ConnectionState::Degraded:
+    connection_status_label->setText("🟡 " + name + ": Instável");
+    break;
+  case ConnectionState::OpenCircuit:
+    connection_status_label->setText("🔴 " + name + ": Sem conexão (aguardando nova tentativa)");
+    break;
+  case ConnectionState::Probing:
+    connection_status_label->setText("🟠 " + name + ": Reconectando...");
+    break;
+  }
+}
+
+void AutoHideDockWidget::update_filter_stats(const VerseFilterStats &stats) {
+  if (stats.suppressed == 0) {
+    filter_label->setVisible(false);
+    return;
+  }
+  filter_label->setText(QString("Filtro: %1 piscadas ignoradas, %2 aplicadas")
+                            .arg(stats.suppressed)
+                            .arg(stats.confirmed));
+  filter_label->setVisible(true);
+}
+
+static QString format_ms(uint64_t us) {
+  return QString::number(us / 1000.0, 'f', 1);
+}
+
+static QString format_frames(uint64_t us, uint64_t frame_interval_ns) {
+  return QString::number(us * 1000.0 / frame_interval_ns, 'f', 1);
+}
+
+void AutoHideDockWidget::update_latency(const LatencyStats &stats,
+                                        uint64_t frame_interval_ns) {
+  static const struct {
+    LatencyStage stage;
+    const char *name;
+  } rows[] = {
+      {LatencyStage::Response, "Resposta"},
+      {LatencyStage::Detection, "Detecção"},
+      {LatencyStage::TimerFired, "Filtro"},
+      {LatencyStage::Applied, "Aplicado"},
+  };
+
+  QString text = "Etapa      p50 / p95 / p99 (ms)\n";
+  for (const auto &row : rows) {
+    const LatencyHistogram &histogram = stats.histogram(row.stage);
+    if (histogram.count() == 0)
+      continue;
+    text += QString("%1 %2 / %3 / %4\n")
+                .arg(QString::fromUtf8(row.name), -10)
+                .arg(format_ms(histogram.percentile(50)))
+                .arg(format_ms(histogram.percentile(95)))
+                .arg(format_ms(histogram.percentile(99)));
+  }
+
+  const LatencyHistogram &applied = stats.histogram(LatencyStage::Applied);
+  if (frame_interval_ns > 0 && applied.count() > 0) {
+    text += QString("%1 %2 / %3 / %4 quadros\n")
+                .arg(QString("Aplicado"), -10)
+                .arg(format_frames(applied.percentile(50), frame_interval_ns))
+                .arg(format_frames(applied.percentile(95), frame_interval_ns))
+                .arg(format_frames(applied.percentile(99), frame_interval_ns));
+  }
+  text += QString("Pior recente: %1 ms (%2 transições)")
+              .arg(format_ms(stats.worst_recent_us()))
+              .arg(applied.count());
+
+  latency_label->setText(text);
+  latency_group->setVisible(true);
 }
@@ -1,8 +1,10 @@
 #pragma once
 
+#include "latency-stats.hpp"
 #include "presentation-client.hpp"
 #include "plugin-config.hpp"
 #include "scene-controller.hpp"
+#include "verse-filter.hpp"
 #include <QDockWidget>
 #include <QGroupBox>
 #include <QLabel>
@@ -16,6 +18,7 @@ class AutoHideDockWidget : public QWidget {
 
 public:
   std::function<void()> on_settings_changed;
+  std::function<void(bool active)> on_activation_changed;
   explicit AutoHideDockWidget(PluginConfig &config, IPresentationClient **client_ptr,
                               SceneController *controller,
                               QWidget *parent = nullptr);
@@ -23,8 +26,18 @@ public:
 
   // Métodos de controle
   void set_active(bool active, bool restore_state = true);
-  void update_connection_status(bool connected);
+  // Estado da conexão (circuit breaker dos clientes)
+  void update_connection_status(ConnectionState state);
+  // Algum cliente respondeu (false = nenhum responde)
+  void update_reachability(bool reachable);
+  // Clientes recriados: volta a "Conectando..." até a primeira resposta
+  void reset_connection_status();
   void update_last_event(bool verse_visible);
+  // p50/p95/p99 por etapa e pior amostra recente. Com frame_interval_ns,
+  // inclui a latência aplicada em quadros.
+  void update_latency(const LatencyStats &stats, uint64_t frame_interval_ns = 0);
+  // Mudanças ignoradas pelo filtro de versículo
+  void update_filter_stats(const VerseFilterStats &stats);
   
   bool is_active() const { return plugin_active; }
   void update_ui_state();
@@ -45,11 +58,20 @@ private:
   QPushButton *toggle_button;
   QLabel *status_label;
   QLabel *last_event_label;
+  QLabel *filter_label;
   QGroupBox *sources_group;
   QLabel *sources_list_label;
   QPushButton *settings_button;
+  QGroupBox *latency_group;
+  QLabel *latency_label;
 
   bool plugin_active = false;
+  // Último estado recebido dos clientes (o rótulo é desenhado a partir dele)
+  ConnectionState connection_state = ConnectionState::Connected;
+  bool server_answered = false;
 
   void setup_ui();
+  void render_connection_status();
+  // Nome do software, ou dos clientes do grupo ("Holyrics + ProPresent")
+  QString clients_name() const;
 };
@@ -0,0 +1,190 @@
+#include "client-group.hpp"
+#include "plugin-log.hpp"
+#include <QThread>
+
+ClientCombine client_combine_from_string(const QString &value) {
+  if (value == "all")
+    return ClientCombine::All;
+  if (value == "priority")
+    return ClientCombine::Priority;
+  return ClientCombine::Any;
+}
+
+ClientGroup::ClientGroup(QObject *parent) : QObject(parent), scheduler(this) {}
+
+ClientGroup::~ClientGroup() {
+  // Antes do scheduler: os pipelines se descadastram ao parar
+  for (Member &member : members)
+    delete member.client;
+  members.clear();
+}
+
+void ClientGroup::add_client(IPresentationClient *client, const QString &url) {
+  // Filho do grupo: acompanha o moveToThread() do grupo
+  if (QObject *object = dynamic_cast<QObject *>(client))
+    object->setParent(this);
+
+  const size_t index = members.size();
+  members.push_back({client, url, false, false, false,
+                     ConnectionState::Connected});
+  client->set_poll_scheduler(&scheduler);
+
+  client->on_verse_changed = [this, index](bool visible,
+                                           const TransitionTrace &trace) {
+    members[index].verse_visible = visible;
+    update_state(trace);
+  };
+  client->on_deactivation_requested = [this]() {
+    if (on_deactivation_requested)
+      on_deactivation_requested();
+  };
+  client->on_reachability_changed = [this, index](bool reachable) {
+    members[index].reachable = reachable;
+    update_reachability();
+    // Prioridade: quem decide pode ter mudado
+    // (sem trace: não é uma mudança de slide, fica fora da latência)
+    if (combine == ClientCombine::Priority)
+      update_state(TransitionTrace());
+  };
+  client->on_upcoming_changed = [this, index](bool upcoming) {
+    members[index].upcoming_verse = upcoming;
+    update_upcoming();
+  };
+  client->on_connection_state_changed = [this, index](ConnectionState state) {
+    members[index].connection_state = state;
+    update_connection_state();
+  };
+}
+
+void ClientGroup::set_combine(ClientCombine mode) { combine = mode; }
+
+void ClientGroup::set_polling_interval(int ms) {
+  // N clientes no mesmo intervalo: uma consulta a cada ms/N no pior caso
+  scheduler.set_min_spacing(members.empty() ? 0 : ms / size());
+}
+
+void ClientGroup::connect(const QString &url) {
+  if (QThread::currentThread() != thread()) {
+    QMetaObject::invokeMethod(
+        this, [this, url]() { connect(url); }, Qt::QueuedConnection);
+    return;
+  }
+
+  connected = true;
+  for (Member &member : members)
+    member.client->connect(member.url.isEmpty() ? url : member.url);
+}
+
+void ClientGroup::disconnect() {
+  if (QThread::currentThread() != thread()) {
+    QMetaObject::invokeMethod(
+        this, [this]() { disconnect(); }, Qt::BlockingQueuedConnection);
+    return;
+  }
+
+  for (Member &member : members) {
+    member.client->disconnect();
+    member.verse_visible = false;
+    member.reachable = false;
+    member.upcoming_verse = false;
+    member.connection_state = ConnectionState::Connected;
+  }
+  connected = false;
+  combined_visible = false;
+  combined_reachable = false;
+  combined_upcoming = false;
+  combined_connection = ConnectionState::Connected;
+}
+
+bool ClientGroup::is_connected() { return connected; }
+
+bool ClientGroup::evaluate() const {
+  switch (combine) {
+  case ClientCombine::All:
+    for (const Member &member : members) {
+      if (!member.verse_visible)
+        return false;
+    }
+    return !members.empty();
+
+  case ClientCombine::Priority:
+    for (const Member &member : members) {
+      if (member.reachable)
+        return member.verse_visible;
+    }
+    // Ninguém respondendo: vale o cliente principal
+    return !members.empty() && members.front().verse_visible;
+
+  case ClientCombine::Any:
+    break;
+  }
+
+  for (const Member &member : members) {
+    if (member.verse_visible)
+      return true;
+  }
+  return false;
+}
+
+void ClientGroup::update_state(const TransitionTrace &trace) {
+  const bool visible = evaluate();
+  if (visible == combined_visible)
+    return;
+
+  combined_visible = visible;
+  if (members.size() > 1) {
+    PluginLog::write(LogLevel::Debug,
+                     "[Auto Hide DEBUG] Grupo de clientes: estado combinado %s",
+                     visible ? "VERSÍCULO" : "NORMAL");
+  }
+  if (on_verse_changed)
+    on_verse_changed(visible, trace);
+}
+
+void ClientGroup::update_reachability() {
+  bool reachable = false;
+  for (const Member &member : members)
+    reachable = reachable || member.reachable;
+
+  if (reachable == combined_reachable)
+    return;
+  combined_reachable = reachable;
+  if (on_reachability_changed)
+    on_reachability_changed(reachable);
+}
+
+void ClientGroup::update_upcoming() {
+  // Pré-armar não custa nada na tela: basta um cliente prever o versículo
+  bool upcoming = false;
+  for (const Member &member : members)
+    upcoming = upcoming || member.upcoming_verse;
+
+  if (upcoming == combined_upcoming)
+    return;
+  combined_upcoming = upcoming;
+  if (on_upcoming_changed)
+    on_upcoming_changed(upcoming);
+}
+
+void ClientGroup::update_connection_state() {
+  // Todos iguais: esse estado. Misturado: instável se alguém responde,
+  // senão reconectando.
+  ConnectionState state = members.empty() ? ConnectionState::Connected
+                                          : members.front().connection_state;
+  bool mixed = false;
+  bool any_answering = false;
+  for (const Member &member : members) {
+    mixed = mixed || member.connection_state != state;
+    any_answering = any_answering ||
+                    member.connection_state == ConnectionState::Connected ||
+                    member.connection_state == ConnectionState::Degraded;
+  }
+  if (mixed)
+    state = any_answering ? ConnectionState::Degraded : ConnectionState::Probing;
+
+  if (state == combined_connection)
+    return;
+  combined_connection = state;
+  if (on_connection_state_changed)
+    on_connection_state_changed(state);
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "poll-scheduler.hpp"
+#include "presentation-client.hpp"
+#include <QObject>
+#include <QString>
+#include <atomic>
+#include <vector>
+
+// Como combinar o estado de vários clientes
+enum class ClientCombine {
+  Any,     // Versículo se qualquer cliente mostra versículo
+  All,     // Versículo só se todos mostram
+  Priority // O primeiro cliente (na ordem) que está respondendo decide
+};
+
+ClientCombine client_combine_from_string(const QString &value);
+
+// Vários clientes de apresentação como um só (ex: Holyrics nas letras e
+// ProPresenter nos slides da pregação, em máquinas diferentes). O grupo é
+// o dono dos clientes, que vivem na mesma thread e compartilham um
+// PollScheduler. Só mudanças no estado combinado saem em on_verse_changed;
+// o VerseStateFilter continua filtrando a decisão final.
+class ClientGroup : public QObject, public IPresentationClient {
+  Q_OBJECT
+
+public:
+  explicit ClientGroup(QObject *parent = nullptr);
+  ~ClientGroup() override;
+
+  // Ordem de inclusão = prioridade. url vazia = usa a URL de connect().
+  // Deve ser chamado antes de moveToThread().
+  void add_client(IPresentationClient *client, const QString &url = QString());
+  void set_combine(ClientCombine mode);
+  // Intervalo de cada cliente; o agendador espaça as consultas entre eles
+  void set_polling_interval(int ms);
+
+  int size() const { return static_cast<int>(members.size()); }
+  IPresentationClient *client(int index) const { return members[index].client; }
+
+  void connect(const QString &url) override;
+  void disconnect() override;
+  bool is_connected() override;
+
+private:
+  struct Member {
+    IPresentationClient *client = nullptr;
+    QString url;
+    bool verse_visible = false;
+    bool reachable = false;
+    bool upcoming_verse = false;
+    ConnectionState connection_state = ConnectionState::Connected;
+  };
+
+  PollScheduler scheduler;
+  std::vector<Member> members;
+  ClientCombine combine = ClientCombine::Any;
+  std::atomic<bool> connected{false};
+  bool combined_visible = false;
+  bool combined_reachable = false;
+  bool combined_upcoming = false;
+  ConnectionState combined_connection = ConnectionState::Connected;
+
+  bool evaluate() const;
+  void update_state(const TransitionTrace &trace);
+  void update_reachability();
+  void update_upcoming();
+  void update_connection_state();
+};
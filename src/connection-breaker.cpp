@@ -0,0 +1,84 @@
+#include "connection-breaker.hpp"
+#include <QRandomGenerator>
+#include <algorithm>
+
+// Falhas seguidas até abrir o circuito (as primeiras podem ser só um
+// pacote perdido no Wi-Fi)
+static constexpr int kOpenAfterFailures = 3;
+static constexpr int kInitialBackoffMs = 2000;
+static constexpr int kMaxBackoffMs = 30000;
+// ±20%: vários clientes (ou plugins) não voltam todos no mesmo instante
+static constexpr int kJitterPercent = 20;
+
+const char *connection_state_name(ConnectionState state) {
+  switch (state) {
+  case ConnectionState::Connected:
+    return "conectado";
+  case ConnectionState::Degraded:
+    return "instável";
+  case ConnectionState::OpenCircuit:
+    return "circuito aberto";
+  case ConnectionState::Probing:
+    return "sondando";
+  }
+  return "?";
+}
+
+bool ConnectionBreaker::set_state(ConnectionState state) {
+  if (state == current)
+    return false;
+  current = state;
+  return true;
+}
+
+bool ConnectionBreaker::record_success() {
+  consecutive_failures = 0;
+  current_backoff_ms = 0;
+  return set_state(ConnectionState::Connected);
+}
+
+bool ConnectionBreaker::record_failure() {
+  consecutive_failures++;
+
+  if (current == ConnectionState::Probing) {
+    // Sondagem falhou: espera o dobro
+    current_backoff_ms =
+        current_backoff_ms == 0
+            ? kInitialBackoffMs
+            : std::min(current_backoff_ms * 2, kMaxBackoffMs);
+    return set_state(ConnectionState::OpenCircuit);
+  }
+
+  if (consecutive_failures >= kOpenAfterFailures) {
+    if (current != ConnectionState::OpenCircuit)
+      current_backoff_ms = kInitialBackoffMs;
+    return set_state(ConnectionState::OpenCircuit);
+  }
+  return set_state(ConnectionState::Degraded);
+}
+
+bool ConnectionBreaker::begin_request() {
+  if (current != ConnectionState::OpenCircuit)
+    return false;
+  return set_state(ConnectionState::Probing);
+}
+
+bool ConnectionBreaker::reset() {
+  consecutive_failures = 0;
+  current_backoff_ms = 0;
+  if (current == ConnectionState::Connected)
+    return false;
+  return set_state(ConnectionState::Probing);
+}
+
+int ConnectionBreaker::next_delay_ms(int interval_ms) const {
+  if (current != ConnectionState::OpenCircuit)
+    return interval_ms;
+
+  // Nunca mais frequente que o polling normal
+  const int base = std::max(current_backoff_ms, interval_ms);
+  const int spread = base * kJitterPercent / 100;
+  if (spread <= 0)
+    return base;
+  return base - spread + QRandomGenerator::global()->bounded(2 * spread + 1);
+}
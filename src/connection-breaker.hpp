@@ -0,0 +1,38 @@
+#pragma once
+
+// Estado da conexão com o servidor de apresentação
+enum class ConnectionState {
+  Connected,   // Respondendo
+  Degraded,    // Falhas recentes, ainda no intervalo normal
+  OpenCircuit, // Fora do ar: sem consultas até o fim do backoff
+  Probing      // Uma consulta de teste em andamento
+};
+
+const char *connection_state_name(ConnectionState state);
+
+// Circuit breaker do polling. Connected -(falha)-> Degraded -(N falhas
+// seguidas)-> OpenCircuit -(backoff)-> Probing -(sucesso)-> Connected;
+// uma sondagem que falha reabre o circuito com o dobro do backoff.
+// Os métodos que mudam o estado retornam true quando ele mudou.
+class ConnectionBreaker {
+public:
+  ConnectionState state() const { return current; }
+
+  bool record_success();
+  bool record_failure();
+  // Início de uma consulta: com o circuito aberto ela é a sondagem
+  bool begin_request();
+  // Endpoint novo: esquece as falhas (sai do circuito aberto sondando)
+  bool reset();
+
+  // Atraso até a próxima consulta: o intervalo normal ou o backoff com jitter
+  int next_delay_ms(int interval_ms) const;
+  int backoff_ms() const { return current_backoff_ms; }
+
+private:
+  ConnectionState current = ConnectionState::Connected;
+  int consecutive_failures = 0;
+  int current_backoff_ms = 0;
+
+  bool set_state(ConnectionState state);
+};
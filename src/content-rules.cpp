@@ -0,0 +1,128 @@
+#include "content-rules.hpp"
+#include "plugin-log.hpp"
+
+static constexpr size_t kTypeCount = static_cast<size_t>(ContentType::Count);
+
+static const char *const kTypeNames[kTypeCount] = {
+    "EMPTY", "BIBLE", "MUSIC", "TEXT", "ANNOUNCEMENT", "IMAGE", "OTHER"};
+
+struct ActionName {
+  ContentAction action;
+  const char *name;
+};
+
+static const ActionName kActionNames[] = {
+    {ContentAction::Show, "show"},
+    {ContentAction::Hide, "hide"},
+    {ContentAction::HideIfText, "hide_if_text"},
+    {ContentAction::Keep, "keep"},
+    {ContentAction::Deactivate, "deactivate"},
+};
+
+const char *content_type_name(ContentType type) {
+  const size_t index = static_cast<size_t>(type);
+  return index < kTypeCount ? kTypeNames[index] : "OTHER";
+}
+
+const char *content_action_name(ContentAction action) {
+  for (const ActionName &entry : kActionNames) {
+    if (entry.action == action)
+      return entry.name;
+  }
+  return "show";
+}
+
+bool content_action_from_string(const QString &value, ContentAction &action) {
+  for (const ActionName &entry : kActionNames) {
+    if (value.compare(QLatin1String(entry.name), Qt::CaseInsensitive) == 0) {
+      action = entry.action;
+      return true;
+    }
+  }
+  return false;
+}
+
+QMap<QString, QString> default_content_rules() {
+  return {
+      {"BIBLE", "hide_if_text"},
+      {"MUSIC", "hide"},
+      {"TEXT", "show"},
+      {"ANNOUNCEMENT", "show"},
+      {"IMAGE", "show"},
+      {"EMPTY", "show"},
+      {"OTHER", "show"},
+  };
+}
+
+ContentRuleTable::ContentRuleTable() {
+  actions.fill(ContentAction::Show);
+  slot(ContentType::Bible) = ContentAction::HideIfText;
+  slot(ContentType::Music) = ContentAction::Hide;
+}
+
+bool ContentRuleTable::parse_type(const QString &type, ContentType &out) {
+  if (type.isEmpty()) {
+    out = ContentType::Empty;
+    return true;
+  }
+  // Tamanho fixo: no máximo 7 comparações curtas por consulta
+  for (size_t i = 0; i < kTypeCount; i++) {
+    if (type.compare(QLatin1String(kTypeNames[i]), Qt::CaseInsensitive) == 0) {
+      out = static_cast<ContentType>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+ContentRuleTable ContentRuleTable::compile(const QMap<QString, QString> &rules,
+                                           bool disable_in_music) {
+  ContentRuleTable table;
+
+  for (auto it = rules.constBegin(); it != rules.constEnd(); ++it) {
+    ContentAction action;
+    if (!content_action_from_string(it.value().trimmed(), action)) {
+      PluginLog::write(LogLevel::Warning,
+                       "[Auto Hide] Regra ignorada: perfil '%s' desconhecido "
+                       "para o tipo '%s'",
+                       it.value().toUtf8().constData(),
+                       it.key().toUtf8().constData());
+      continue;
+    }
+
+    const QString type = it.key().trimmed();
+    ContentType known;
+    if (parse_type(type, known))
+      table.slot(known) = action;
+    else
+      table.custom.insert(type.toUpper(), action);
+  }
+
+  if (disable_in_music)
+    table.slot(ContentType::Music) = ContentAction::Deactivate;
+
+  for (size_t i = 0; i < kTypeCount; i++) {
+    PluginLog::write(LogLevel::Debug, "[Auto Hide DEBUG] Regra: %s -> %s",
+                     kTypeNames[i], content_action_name(table.actions[i]));
+  }
+  for (auto it = table.custom.constBegin(); it != table.custom.constEnd(); ++it) {
+    PluginLog::write(LogLevel::Debug, "[Auto Hide DEBUG] Regra: %s -> %s",
+                     it.key().toUtf8().constData(),
+                     content_action_name(it.value()));
+  }
+
+  return table;
+}
+
+ContentAction ContentRuleTable::action_for(const QString &type) const {
+  ContentType known;
+  if (parse_type(type, known))
+    return actions[static_cast<size_t>(known)];
+
+  if (!custom.isEmpty()) {
+    auto it = custom.constFind(type.toUpper());
+    if (it != custom.constEnd())
+      return it.value();
+  }
+  return actions[static_cast<size_t>(ContentType::Other)];
+}
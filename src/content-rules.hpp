@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QHash>
+#include <QMap>
+#include <QString>
+#include <array>
+
+// Tipos de conteúdo conhecidos do Holyrics (map.type)
+enum class ContentType {
+  Empty, // Tela limpa / type vazio
+  Bible,
+  Music,
+  Text,
+  Announcement,
+  Image,
+  Other, // Qualquer tipo sem regra própria
+  Count
+};
+
+// Perfis de ação por tipo de conteúdo
+enum class ContentAction {
+  Show,       // Fontes visíveis (estado normal)
+  Hide,       // Esconde as fontes
+  HideIfText, // Esconde só se o slide tiver texto (BIBLE vazio = F9)
+  Keep,       // Mantém o estado atual
+  Deactivate  // Esconde e desativa o plugin (uma vez, na entrada)
+};
+
+const char *content_type_name(ContentType type);
+const char *content_action_name(ContentAction action);
+bool content_action_from_string(const QString &value, ContentAction &action);
+
+// Regras padrão (equivalem ao comportamento antigo): chave = tipo, valor = perfil
+QMap<QString, QString> default_content_rules();
+
+// Regras compiladas: tipo conhecido → índice fixo; tipos desconhecidos do
+// código ficam num hash. Consulta sem alocação no caso comum.
+class ContentRuleTable {
+public:
+  ContentRuleTable();
+
+  // disable_in_music: MUSIC passa a desativar o plugin (opção antiga)
+  static ContentRuleTable compile(const QMap<QString, QString> &rules,
+                                  bool disable_in_music);
+
+  ContentAction action_for(const QString &type) const;
+
+private:
+  std::array<ContentAction, static_cast<size_t>(ContentType::Count)> actions;
+  QHash<QString, ContentAction> custom; // Chave em maiúsculas
+
+  static bool parse_type(const QString &type, ContentType &out);
+  ContentAction &slot(ContentType type) {
+    return actions[static_cast<size_t>(type)];
+  }
+};
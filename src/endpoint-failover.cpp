@@ -0,0 +1,160 @@
+#include "endpoint-failover.hpp"
+#include "plugin-log.hpp"
+#include <QNetworkRequest>
+#include <QUrl>
+#include <utility>
+
+// Verificação dos endpoints fora de uso: espaçada, só precisa estar pronta
+// antes da próxima queda
+static constexpr int kHealthCheckMs = 10000;
+// Um endpoint que não responde os cabeçalhos nesse tempo conta como fora
+static constexpr int kProbeTimeoutMs = 2000;
+
+EndpointFailover::EndpointFailover(QNetworkAccessManager *manager,
+                                   QObject *parent)
+    : QObject(parent), network_manager(manager), health_timer(this) {
+  health_timer.setInterval(kHealthCheckMs);
+  QObject::connect(&health_timer, &QTimer::timeout, this,
+                   &EndpointFailover::run_health_checks);
+}
+
+EndpointFailover::~EndpointFailover() { abort_probes(); }
+
+void EndpointFailover::set_endpoints(const QStringList &base_urls) {
+  abort_probes();
+  endpoints.clear();
+  for (const QString &url : base_urls) {
+    if (!url.isEmpty())
+      endpoints.push_back({url, true, nullptr});
+  }
+  active = 0;
+}
+
+void EndpointFailover::set_probe_path(const QString &path) {
+  probe_path = path.startsWith("/") ? path : "/" + path;
+}
+
+void EndpointFailover::start() {
+  // Um endpoint só: nada a verificar
+  if (endpoints.size() > 1)
+    health_timer.start();
+}
+
+void EndpointFailover::stop() {
+  health_timer.stop();
+  abort_probes();
+}
+
+const QString &EndpointFailover::active_url() const {
+  static const QString empty;
+  return endpoints.empty() ? empty : endpoints[active].base_url;
+}
+
+bool EndpointFailover::report_failure() {
+  if (endpoints.size() < 2)
+    return false;
+
+  endpoints[active].healthy = false;
+  // Primeiro saudável na ordem da lista
+  for (size_t i = 0; i < endpoints.size(); i++) {
+    if (i != active && endpoints[i].healthy) {
+      switch_to(i, "ativo sem resposta");
+      return true;
+    }
+  }
+  return false;
+}
+
+void EndpointFailover::report_success() {
+  if (!endpoints.empty())
+    endpoints[active].healthy = true;
+}
+
+void EndpointFailover::run_health_checks() {
+  for (size_t i = 0; i < endpoints.size(); i++) {
+    if (i != active && !endpoints[i].probe)
+      probe(i);
+  }
+}
+
+void EndpointFailover::probe(size_t index) {
+  QNetworkRequest request(QUrl(endpoints[index].base_url + probe_path));
+  request.setHeader(QNetworkRequest::UserAgentHeader, "OBS Auto Hide Plugin");
+  request.setTransferTimeout(kProbeTimeoutMs);
+
+  QNetworkReply *reply = network_manager->get(request);
+  endpoints[index].probe = reply;
+
+  // Cabeçalhos bastam: o corpo não interessa. 5xx não conta como saudável
+  // (evita ir e voltar para um servidor que responde só com erro).
+  QObject::connect(reply, &QNetworkReply::metaDataChanged, this,
+                   [this, index, reply]() {
+                     if (index >= endpoints.size() ||
+                         endpoints[index].probe != reply)
+                       return;
+                     const int status =
+                         reply->attribute(QNetworkRequest::HttpStatusCodeAttribute)
+                             .toInt();
+                     finish_probe(index, status > 0 && status < 500);
+                   });
+  QObject::connect(reply, &QNetworkReply::finished, this,
+                   [this, index, reply]() {
+                     if (index < endpoints.size() &&
+                         endpoints[index].probe == reply)
+                       finish_probe(index,
+                                    reply->error() == QNetworkReply::NoError);
+                   });
+}
+
+void EndpointFailover::finish_probe(size_t index, bool healthy) {
+  QNetworkReply *reply = endpoints[index].probe;
+  endpoints[index].probe = nullptr;
+  QObject::disconnect(reply, nullptr, this, nullptr);
+  reply->abort();
+  reply->deleteLater();
+
+  if (healthy != endpoints[index].healthy) {
+    PluginLog::write(LogLevel::Debug,
+                     "[Auto Hide DEBUG] Endpoint %s %s",
+                     endpoints[index].base_url.toUtf8().constData(),
+                     healthy ? "respondendo" : "sem resposta");
+  }
+  endpoints[index].healthy = healthy;
+
+  // Volta para um endpoint de maior prioridade, ou sai de um ativo caído
+  if (healthy && (index < active || !endpoints[active].healthy))
+    switch_to(index, index < active ? "prioridade maior respondendo"
+                                    : "ativo sem resposta");
+}
+
+void EndpointFailover::abort_probes() {
+  for (Endpoint &endpoint : endpoints) {
+    if (!endpoint.probe)
+      continue;
+    QNetworkReply *reply = std::exchange(endpoint.probe, nullptr);
+    QObject::disconnect(reply, nullptr, this, nullptr);
+    reply->abort();
+    reply->deleteLater();
+  }
+}
+
+void EndpointFailover::switch_to(size_t index, const char *reason) {
+  if (index == active || index >= endpoints.size())
+    return;
+
+  PluginLog::write(LogLevel::Warning,
+                   "[Auto Hide] Trocando de endpoint (%s): %s -> %s", reason,
+                   endpoints[active].base_url.toUtf8().constData(),
+                   endpoints[index].base_url.toUtf8().constData());
+  active = index;
+
+  // Sondagem pendente do novo ativo não vale mais: o cliente assume
+  if (QNetworkReply *reply = std::exchange(endpoints[active].probe, nullptr)) {
+    QObject::disconnect(reply, nullptr, this, nullptr);
+    reply->abort();
+    reply->deleteLater();
+  }
+
+  if (on_switched)
+    on_switched(endpoints[active].base_url);
+}
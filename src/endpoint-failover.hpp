@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+#include <functional>
+#include <vector>
+
+// Lista ordenada de endpoints de um cliente (ex: PC de projeção principal
+// e reserva). O ativo é consultado pelo cliente; os outros recebem só uma
+// verificação leve de tempos em tempos (GET abortado assim que chegam os
+// cabeçalhos). Uma falha do ativo troca na hora para o próximo saudável e
+// o primário volta a ser usado quando responder de novo.
+class EndpointFailover : public QObject {
+  Q_OBJECT
+
+public:
+  EndpointFailover(QNetworkAccessManager *manager, QObject *parent = nullptr);
+  ~EndpointFailover() override;
+
+  // Ordem = prioridade. URLs sem a barra final.
+  void set_endpoints(const QStringList &base_urls);
+  // Caminho barato usado na verificação (relativo à URL base)
+  void set_probe_path(const QString &path);
+
+  void start();
+  void stop();
+
+  const QString &active_url() const;
+  int size() const { return static_cast<int>(endpoints.size()); }
+
+  // O ativo falhou: troca para o próximo saudável (true = trocou)
+  bool report_failure();
+  void report_success();
+
+  // Endpoint ativo mudou (base_url nova)
+  std::function<void(const QString &base_url)> on_switched;
+
+private:
+  struct Endpoint {
+    QString base_url;
+    bool healthy = true; // Sem verificação ainda: assume que responde
+    QNetworkReply *probe = nullptr;
+  };
+
+  QNetworkAccessManager *network_manager;
+  std::vector<Endpoint> endpoints;
+  size_t active = 0;
+  QString probe_path;
+  QTimer health_timer;
+
+  void run_health_checks();
+  void probe(size_t index);
+  void finish_probe(size_t index, bool healthy);
+  void abort_probes();
+  void switch_to(size_t index, const char *reason);
+};
@@ -0,0 +1,125 @@
+#include "feed-trace.hpp"
+#include "plugin-log.hpp"
+#include <QHash>
+#include <QtEndian>
+#include <cstring>
+#include <filesystem>
+#include <util/platform.h>
+
+static constexpr char kMagic[8] = {'A', 'H', 'T', 'R', 'A', 'C', 'E', '1'};
+static constexpr uint32_t kVersion = 1;
+static constexpr qint64 kRecordHeaderBytes = 16;
+
+bool FeedTraceWriter::open(const QString &path, TraceClient client) {
+  close();
+
+  // Mesmo cuidado do save_to_file: std::filesystem em vez de QDir::mkpath
+  std::error_code ec;
+#ifdef _WIN32
+  std::filesystem::path fs_path(path.toStdWString());
+#else
+  std::filesystem::path fs_path(path.toUtf8().constData());
+#endif
+  std::filesystem::create_directories(fs_path.parent_path(), ec);
+
+  file.setFileName(path);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    PluginLog::write(LogLevel::Warning,
+                     "[Auto Hide] Não foi possível criar o trace: %s",
+                     path.toUtf8().constData());
+    return false;
+  }
+
+  uchar header[16] = {};
+  std::memcpy(header, kMagic, sizeof(kMagic));
+  qToLittleEndian<uint32_t>(kVersion, header + 8);
+  header[12] = static_cast<uchar>(client);
+  file.write(reinterpret_cast<const char *>(header), sizeof(header));
+  file.flush();
+
+  start_ns = os_gettime_ns();
+  last_hash[0] = last_hash[1] = 0;
+  last_size[0] = last_size[1] = -1;
+  return true;
+}
+
+void FeedTraceWriter::close() {
+  if (file.isOpen())
+    file.close();
+}
+
+void FeedTraceWriter::append(TraceSource source, QByteArrayView body) {
+  if (!file.isOpen())
+    return;
+
+  const int slot = static_cast<int>(source);
+  const size_t body_hash = qHash(body);
+  if (body.size() == last_size[slot] && body_hash == last_hash[slot])
+    return;
+  last_hash[slot] = body_hash;
+  last_size[slot] = body.size();
+
+  uchar header[kRecordHeaderBytes] = {};
+  qToLittleEndian<quint64>(os_gettime_ns() - start_ns, header);
+  qToLittleEndian<quint32>(static_cast<quint32>(body.size()), header + 8);
+  header[12] = static_cast<uchar>(source);
+
+  file.write(reinterpret_cast<const char *>(header), sizeof(header));
+  file.write(body.data(), body.size());
+  // Só grava em mudanças de conteúdo: flush a cada registro sai barato e
+  // preserva o trace se o OBS fechar no meio do culto
+  file.flush();
+}
+
+bool FeedTraceReader::open(const QString &path, QString *error) {
+  close();
+
+  file.setFileName(path);
+  if (!file.open(QIODevice::ReadOnly)) {
+    if (error)
+      *error = file.errorString();
+    return false;
+  }
+
+  size = file.size();
+  data = size >= kHeaderBytes ? file.map(0, size) : nullptr;
+  if (!data || std::memcmp(data, kMagic, sizeof(kMagic)) != 0 ||
+      qFromLittleEndian<quint32>(data + 8) != kVersion) {
+    if (error)
+      *error = "Arquivo não é um trace válido";
+    close();
+    return false;
+  }
+
+  trace_client = static_cast<TraceClient>(data[12]);
+  position = kHeaderBytes;
+  return true;
+}
+
+void FeedTraceReader::close() {
+  if (data) {
+    file.unmap(const_cast<uchar *>(data));
+    data = nullptr;
+  }
+  if (file.isOpen())
+    file.close();
+  size = 0;
+  position = 0;
+}
+
+bool FeedTraceReader::next(FeedTraceRecord &record) {
+  if (!data || size - position < kRecordHeaderBytes)
+    return false;
+
+  const uchar *header = data + position;
+  const quint32 body_size = qFromLittleEndian<quint32>(header + 8);
+  if (size - position - kRecordHeaderBytes < body_size)
+    return false;
+
+  record.timestamp_ns = qFromLittleEndian<quint64>(header);
+  record.source = static_cast<TraceSource>(header[12]);
+  record.body = QByteArrayView(
+      reinterpret_cast<const char *>(header + kRecordHeaderBytes), body_size);
+  position += kRecordHeaderBytes + body_size;
+  return true;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QFile>
+#include <QString>
+#include <cstdint>
+
+// Trace do feed de apresentação: corpos de resposta gravados durante o
+// culto para reproduzir a detecção offline.
+//
+// Formato (little-endian):
+//   Cabeçalho (16 bytes): "AHTRACE1" | u32 versão | u8 cliente | 3 reservados
+//   Registro  (16 bytes + corpo): u64 ns desde o início da gravação |
+//                                 u32 tamanho | u8 origem | 3 reservados | corpo
+// Um registro truncado no fim (gravação interrompida) é ignorado na leitura.
+
+enum class TraceClient : uint8_t { Holyrics = 0, ProPresent = 1 };
+
+enum class TraceSource : uint8_t {
+  Poll = 0,  // Corpo completo de uma consulta (caminho do on_response)
+  Stream = 1 // Mensagem do stream de status (modo push)
+};
+
+struct FeedTraceRecord {
+  uint64_t timestamp_ns = 0;
+  TraceSource source = TraceSource::Poll;
+  QByteArrayView body; // Aponta para o arquivo mapeado
+};
+
+// Grava registros só quando o conteúdo muda (por origem)
+class FeedTraceWriter {
+public:
+  ~FeedTraceWriter() { close(); }
+
+  bool open(const QString &path, TraceClient client);
+  void close();
+  bool is_open() const { return file.isOpen(); }
+  QString path() const { return file.fileName(); }
+
+  void append(TraceSource source, QByteArrayView body);
+
+private:
+  QFile file;
+  uint64_t start_ns = 0;
+  // Último corpo gravado por origem
+  size_t last_hash[2] = {0, 0};
+  qsizetype last_size[2] = {-1, -1};
+};
+
+// Leitura sequencial sobre o arquivo mapeado em memória (QFile::map)
+class FeedTraceReader {
+public:
+  ~FeedTraceReader() { close(); }
+
+  bool open(const QString &path, QString *error = nullptr);
+  void close();
+
+  TraceClient client() const { return trace_client; }
+  // false no fim do arquivo (ou num registro truncado)
+  bool next(FeedTraceRecord &record);
+  void rewind() { position = kHeaderBytes; }
+
+private:
+  static constexpr qint64 kHeaderBytes = 16;
+
+  QFile file;
+  const uchar *data = nullptr;
+  qint64 size = 0;
+  qint64 position = 0;
+  TraceClient trace_client = TraceClient::Holyrics;
+};
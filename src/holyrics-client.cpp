@@ -1,201 +1,606 @@
 #include "holyrics-client.hpp"
+#include "json-scanner.hpp"
 #include <obs-module.h>
 #include <QNetworkRequest>
 #include <QNetworkReply>
+#include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonValue>
-#include <QRegularExpression>
-
-HolyricsClient::HolyricsClient(QObject *parent) : QObject(parent) {
+#include <QDateTime>
+#include <QThread>
+#include <util/platform.h>
+#include <utility>
+
+// Tempo até tentar reabrir o stream depois de uma queda
+static constexpr int kStreamRetryMs = 5000;
+// O próximo item muda pouco: consulta mais espaçada que o slide atual
+static constexpr int kNextItemPollMs = 2000;
+
+HolyricsClient::HolyricsClient(QObject *parent)
+    : QObject(parent), stream_retry_timer(this) {
   network_manager = new QNetworkAccessManager(this);
-
-  // Configurar timer
-  polling_timer.setTimerType(Qt::PreciseTimer);
-  QObject::connect(&polling_timer, &QTimer::timeout, this,
-                   &HolyricsClient::check_view);
+  status_stream = new StatusStream(network_manager, this);
+  pipeline = new RequestPipeline(network_manager, this);
+
+  // Uma requisição por vez; a próxima é agendada ao fim da anterior
+  pipeline->on_response = [this](const QByteArray &data) {
+    trace_writer.append(TraceSource::Poll, data);
+    begin_trace(pipeline->last_request_sent_ns(), pipeline->last_response_ns());
+    apply_verse_state(detect_verse(data));
+  };
+  // Decide assim que o trecho recebido basta (normalmente só o "type")
+  pipeline->on_partial = [this](const QByteArray &received) {
+    // Gravando: lê sempre o corpo inteiro para o trace
+    if (trace_writer.is_open())
+      return false;
+    begin_trace(pipeline->last_request_sent_ns(), pipeline->last_response_ns());
+    const bool was_visible = verse_was_visible;
+    const ContentAction previous_action = last_action;
+    if (!detect_verse_partial(received))
+      return false;
+    // O corpo em cache não representa mais o estado: a volta a ele
+    // precisa ser reavaliada
+    if (verse_was_visible != was_visible || last_action != previous_action)
+      pipeline->reset_cache();
+    return true;
+  };
+  pipeline->on_error = [this](const QString &error) {
+    // Cada falha só em debug: o aviso sai na abertura do circuito
+    log(LogLevel::Debug, "[Auto Hide DEBUG] Erro de conexão: %s",
+        error.toUtf8().constData());
+    // Reserva pronta: troca na hora, sem passar por "sem resposta"
+    if (!failover->report_failure())
+      set_reachable(false);
+  };
+  pipeline->on_success = [this]() {
+    failover->report_success();
+    set_reachable(true);
+  };
+
+  pipeline->on_state_changed = [this](ConnectionState state) {
+    set_connection_state(state);
+  };
+
+  failover = new EndpointFailover(network_manager, this);
+  failover->set_probe_path("/view/text.json");
+  failover->on_switched = [this](const QString &url) { switch_endpoint(url); };
+
+  // No agendador compartilhado (quando houver) com prioridade baixa: conta
+  // no limite de carga do grupo sem atrasar a consulta do slide atual
+  next_item_pipeline = new RequestPipeline(network_manager, this);
+  next_item_pipeline->set_interval(kNextItemPollMs);
+  next_item_pipeline->on_response = [this](const QByteArray &data) {
+    update_upcoming(data);
+  };
+  next_item_pipeline->on_error = [this](const QString &error) {
+    log(LogLevel::Debug, "[Auto Hide DEBUG] Próximo item indisponível: %s",
+        error.toUtf8().constData());
+    set_upcoming(false);
+  };
+
+  stream_retry_timer.setSingleShot(true);
+  stream_retry_timer.setInterval(kStreamRetryMs);
+  QObject::connect(&stream_retry_timer, &QTimer::timeout, this,
+                   &HolyricsClient::open_stream);
+
+  status_stream->on_opened = [this]() {
+    // Stream ativo: o polling vira redundante
+    pipeline->stop();
+    set_connection_state(ConnectionState::Connected);
+    log(LogLevel::Info, "[Auto Hide] Holyrics: stream conectado");
+  };
+  // Cada mensagem tem o mesmo formato de /view/text.json
+  status_stream->on_message = [this](const QByteArray &message) {
+    trace_writer.append(TraceSource::Stream, message);
+    set_reachable(true);
+    // Sem requisição no push: a contagem começa na chegada da mensagem
+    const uint64_t now = os_gettime_ns();
+    begin_trace(now, now);
+    apply_verse_state(detect_verse(message));
+  };
+  status_stream->on_dropped = [this](const QString &reason) {
+    on_stream_dropped(reason);
+  };
 }
 
 HolyricsClient::~HolyricsClient() { disconnect(); }
 
 void HolyricsClient::connect(const QString &url) {
-  base_url = url;
-  if (base_url.endsWith("/")) {
-    base_url.chop(1);
+  // Pode ser chamado da thread da UI: executa na thread do cliente
+  if (QThread::currentThread() != thread()) {
+    QMetaObject::invokeMethod(
+        this, [this, url]() { connect(url); }, Qt::QueuedConnection);
+    return;
+  }
+
+  // Principal primeiro, depois as reservas na ordem
+  QStringList endpoints;
+  for (QString endpoint : QStringList(url) + backup_urls) {
+    if (endpoint.endsWith("/"))
+      endpoint.chop(1);
+    endpoints.append(endpoint);
   }
+  failover->set_endpoints(endpoints);
+  base_url = failover->active_url();
 
-  polling_timer.setInterval(polling_interval_ms);
-  polling_timer.start();
   connected = true;
 
-  blog(LOG_INFO, "[Auto Hide] Conectando ao Holyrics em: %s",
-       base_url.toUtf8().constData());
+  log(LogLevel::Info, "[Auto Hide] Conectando ao Holyrics em: %s",
+      base_url.toUtf8().constData());
 
-  // Primeira verificação imediata
-  check_view();
+  // O polling roda até o stream confirmar que está recebendo dados.
+  // start() já faz a primeira verificação imediata.
+  pipeline->set_url(QUrl(base_url + "/view/text.json"));
+  pipeline->set_interval(polling_interval_ms);
+  pipeline->start();
+  failover->start();
+
+  if (push_mode) {
+    open_stream();
+  }
+
+  start_next_item_polling();
+  start_trace_capture();
 }
 
 void HolyricsClient::disconnect() {
-  polling_timer.stop();
+  // Bloqueia até parar de fato: nenhuma consulta nova depois do retorno
+  if (QThread::currentThread() != thread()) {
+    QMetaObject::invokeMethod(
+        this, [this]() { disconnect(); }, Qt::BlockingQueuedConnection);
+    return;
+  }
+
+  if (connected) {
+    const PollStats &stats = pipeline->stats();
+    log(LogLevel::Info,
+        "[Auto Hide] Holyrics: %llu consultas, %llu sem mudança (ignoradas)",
+        (unsigned long long)stats.requests,
+        (unsigned long long)stats.skipped());
+  }
+
+  pipeline->stop();
+  next_item_pipeline->stop();
+  failover->stop();
+  stream_retry_timer.stop();
+  status_stream->close();
+  trace_writer.close();
   connected = false;
   verse_was_visible = false;
-  blog(LOG_INFO, "[Auto Hide] Desconectado do Holyrics");
+  last_action = ContentAction::Show;
+  upcoming_verse = false;
+  reachable = false;
+  connection_state = ConnectionState::Connected;
+  log(LogLevel::Info, "[Auto Hide] Desconectado do Holyrics");
 }
 
 bool HolyricsClient::is_connected() { return connected; }
 
+void HolyricsClient::set_poll_scheduler(PollScheduler *scheduler) {
+  pipeline->set_scheduler(scheduler);
+  next_item_pipeline->set_scheduler(scheduler, PollPriority::Background);
+}
+
+void HolyricsClient::set_backup_urls(const QStringList &urls) {
+  backup_urls = urls;
+}
+
+void HolyricsClient::switch_endpoint(const QString &url) {
+  // verse_was_visible fica como está: a troca não deve piscar as fontes
+  base_url = url;
+  pipeline->set_url(QUrl(base_url + "/view/text.json"));
+  if (pipeline->is_running() && !pipeline->is_in_flight())
+    pipeline->poll_now();
+  if (next_item_pipeline->is_running())
+    start_next_item_polling();
+  if (push_mode) {
+    stream_retry_timer.stop();
+    status_stream->close();
+    open_stream();
+  }
+}
+
+void HolyricsClient::set_connection_state(ConnectionState state) {
+  if (connection_state == state)
+    return;
+
+  const ConnectionState previous = std::exchange(connection_state, state);
+  if (state == ConnectionState::OpenCircuit &&
+      previous != ConnectionState::Probing) {
+    log(LogLevel::Warning,
+        "[Auto Hide] Holyrics fora do ar: consultas suspensas, nova tentativa em "
+        "~%d s",
+        pipeline->backoff_ms() / 1000);
+  } else if (state == ConnectionState::Connected &&
+             previous != ConnectionState::Degraded) {
+    log(LogLevel::Info, "[Auto Hide] Holyrics respondendo novamente");
+  } else {
+    log(LogLevel::Debug, "[Auto Hide DEBUG] Conexão com Holyrics: %s",
+        connection_state_name(state));
+  }
+
+  if (on_connection_state_changed)
+    on_connection_state_changed(state);
+}
+
+void HolyricsClient::set_reachable(bool value) {
+  if (reachable == value)
+    return;
+  reachable = value;
+  if (on_reachability_changed)
+    on_reachability_changed(value);
+}
+
 void HolyricsClient::set_polling_interval(int ms) {
   polling_interval_ms = ms;
-  if (connected) {
-    polling_timer.setInterval(ms);
-  }
+  pipeline->set_interval(ms);
+}
+
+void HolyricsClient::set_content_rules(const ContentRuleTable &rules) {
+  content_rules = rules;
+  // Reavalia o próximo item com as regras novas
+  next_item_pipeline->reset_cache();
 }
 
-void HolyricsClient::set_disable_in_music(bool disable) {
-    disable_in_music = disable;
+void HolyricsClient::set_transport(PipelineTransport transport) {
+  pipeline->set_transport(transport);
 }
 
-void HolyricsClient::check_view() {
+void HolyricsClient::set_push_mode(bool enabled) {
+  if (push_mode == enabled)
+    return;
+
+  push_mode = enabled;
   if (!connected)
     return;
 
-  QString url = base_url + "/view/text.json";
+  if (push_mode) {
+    open_stream();
+  } else {
+    stream_retry_timer.stop();
+    status_stream->close();
+    pipeline->start();
+  }
+}
 
-  QNetworkRequest request(url);
-  request.setTransferTimeout(2000); // 2 segundos timeout
-  request.setHeader(QNetworkRequest::UserAgentHeader, "OBS Auto Hide Plugin");
+void HolyricsClient::set_stream_path(const QString &path) {
+  if (stream_path == path)
+    return;
 
-  QNetworkReply *reply = network_manager->get(request);
+  stream_path = path;
+  if (connected && push_mode) {
+    open_stream();
+  }
+}
 
-  // Usar lambda para capturar contexto com segurança
-  QObject::connect(reply, &QNetworkReply::finished, [this, reply, url]() {
-    if (reply->error() != QNetworkReply::NoError) {
-      // Apenas logar aviso periodicamente seria ideal para não floodar,
-      // mas por enquanto logamos erro
-      if (polling_timer.isActive()) {
-        blog(LOG_WARNING, "[Auto Hide] Erro de conexão: %s",
-             reply->errorString().toUtf8().constData());
-      }
-    } else {
-      QByteArray data = reply->readAll();
-      QString json_str = QString::fromUtf8(data);
+void HolyricsClient::set_next_item_path(const QString &path) {
+  if (next_item_path == path)
+    return;
 
-      bool verse_visible = detect_verse(json_str);
+  next_item_path = path;
+  if (connected)
+    start_next_item_polling();
+}
 
-      // Estado mudou?
-      if (verse_visible != verse_was_visible) {
-        verse_was_visible = verse_visible;
+void HolyricsClient::start_next_item_polling() {
+  next_item_pipeline->stop();
+  if (next_item_path.isEmpty()) {
+    set_upcoming(false);
+    return;
+  }
 
-        blog(LOG_INFO, "[Auto Hide] Estado mudou: Versículo %s (Type detectado via JSON)",
-             verse_visible ? "VISÍVEL" : "OCULTO");
+  QString path =
+      next_item_path.startsWith("/") ? next_item_path : "/" + next_item_path;
+  next_item_pipeline->set_url(QUrl(base_url + path));
+  next_item_pipeline->start();
+}
 
-        // Notificar callback
-        if (on_verse_changed) {
-          on_verse_changed(verse_visible);
-        }
+// Tipo do próximo item. Formatos aceitos (o Holyrics não documenta um
+// único formato para isso):
+//   {"next": {"type": ...}} / "next_item" / "nextItem", na raiz, em "map"
+//   ou em "data"; ou uma lista em "playlist"/"items"/"data" com o item atual
+//   marcado por "current"/"selected"/"active" = true.
+static bool find_upcoming_type(const QJsonObject &object, QString &type,
+                               int depth = 0) {
+  static const char *const kNextKeys[] = {"next", "next_item", "nextItem"};
+  for (const char *key : kNextKeys) {
+    const QJsonValue next = object.value(QLatin1String(key));
+    if (next.isObject() && next.toObject().contains("type")) {
+      type = next.toObject().value("type").toString();
+      return true;
+    }
+  }
+
+  static const char *const kListKeys[] = {"playlist", "items", "data"};
+  for (const char *key : kListKeys) {
+    const QJsonValue value = object.value(QLatin1String(key));
+    if (!value.isArray())
+      continue;
+
+    const QJsonArray list = value.toArray();
+    for (qsizetype i = 0; i + 1 < list.size(); i++) {
+      const QJsonObject item = list.at(i).toObject();
+      if (item.value("current").toBool() || item.value("selected").toBool() ||
+          item.value("active").toBool()) {
+        type = list.at(i + 1).toObject().value("type").toString();
+        return true;
       }
     }
+  }
 
-    reply->deleteLater();
-  });
+  // Um nível de envelope ("map"/"data")
+  if (depth == 0) {
+    for (const char *key : {"map", "data"}) {
+      const QJsonValue inner = object.value(QLatin1String(key));
+      if (inner.isObject() &&
+          find_upcoming_type(inner.toObject(), type, depth + 1))
+        return true;
+    }
+  }
+  return false;
 }
 
-void HolyricsClient::on_network_reply_finished() {
-  // Implementado via lambda no check_view
+void HolyricsClient::update_upcoming(const QByteArray &data) {
+  const QJsonDocument doc = QJsonDocument::fromJson(data);
+  QString type;
+  if (!doc.isObject() || !find_upcoming_type(doc.object(), type)) {
+    log(LogLevel::Debug,
+        "[Auto Hide DEBUG] Próximo item: formato não reconhecido");
+    set_upcoming(false);
+    return;
+  }
+
+  // Mesmas regras do slide atual: o próximo esconde as fontes?
+  const ContentAction action = content_rules.action_for(type);
+  set_upcoming(action == ContentAction::Hide ||
+               action == ContentAction::HideIfText ||
+               action == ContentAction::Deactivate);
 }
 
-bool HolyricsClient::detect_verse(const QString &raw_data) {
+void HolyricsClient::set_upcoming(bool value) {
+  if (upcoming_verse == value)
+    return;
 
-  QJsonDocument doc = QJsonDocument::fromJson(raw_data.toUtf8());
+  upcoming_verse = value;
+  log(LogLevel::Debug, "[Auto Hide DEBUG] Próximo item %s",
+      value ? "esconde as fontes (pré-armando)" : "não esconde as fontes");
+  if (on_upcoming_changed)
+    on_upcoming_changed(value);
+}
 
-  if (doc.isNull()) {
+void HolyricsClient::set_trace_capture(const QString &directory) {
+  if (trace_directory == directory)
+    return;
 
-      blog(LOG_WARNING, "[Auto Hide DEBUG] JSON inválido ou vazio.");
+  trace_directory = directory;
+  if (connected) {
+    start_trace_capture();
+  }
+}
 
-      return false;
+void HolyricsClient::start_trace_capture() {
+  trace_writer.close();
+  if (trace_directory.isEmpty())
+    return;
 
+  QString path = trace_directory + "/holyrics-" +
+                 QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss") +
+                 ".aht";
+  if (trace_writer.open(path, TraceClient::Holyrics)) {
+    log(LogLevel::Info, "[Auto Hide] Gravando trace do feed em: %s",
+        path.toUtf8().constData());
+    // O estado atual entra no trace já na próxima resposta
+    pipeline->reset_cache();
   }
+}
 
-  if (!doc.isObject()) {
-
-      blog(LOG_WARNING, "[Auto Hide DEBUG] JSON não é um objeto raiz.");
+void HolyricsClient::feed_recorded(TraceSource source, const QByteArray &body) {
+  Q_UNUSED(source); // Stream e polling têm o mesmo formato no Holyrics
+  const uint64_t now = os_gettime_ns();
+  begin_trace(now, now);
+  apply_verse_state(detect_verse(body));
+}
 
-      return false;
+void HolyricsClient::open_stream() {
+  if (!connected || !push_mode)
+    return;
 
+  if (stream_path.isEmpty()) {
+    log(LogLevel::Info, "[Auto Hide] Holyrics: modo push sem caminho de stream "
+                        "configurado, mantendo polling");
+    return;
   }
 
+  QString path = stream_path.startsWith("/") ? stream_path : "/" + stream_path;
+  QNetworkRequest request(QUrl(base_url + path));
+  request.setHeader(QNetworkRequest::UserAgentHeader, "OBS Auto Hide Plugin");
+  request.setRawHeader("Accept", "text/event-stream, application/json");
+  status_stream->open(request);
+}
 
+void HolyricsClient::on_stream_dropped(const QString &reason) {
+  if (!connected)
+    return;
 
-  QJsonObject root = doc.object();
+  log(LogLevel::Warning,
+      "[Auto Hide] Holyrics: stream caiu (%s), voltando ao polling",
+      reason.toUtf8().constData());
 
+  // Volta ao polling e tenta reabrir o stream mais tarde
+  pipeline->start();
+  stream_retry_timer.start();
+}
 
+void HolyricsClient::begin_trace(uint64_t request_sent_ns, uint64_t response_ns) {
+  current_trace = TransitionTrace();
+  current_trace.request_sent_ns = request_sent_ns;
+  current_trace.response_received_ns = response_ns;
+}
 
-  // Logar o JSON inteiro (limitado para não explodir o log)
+void HolyricsClient::apply_verse_state(bool verse_visible) {
+  // Estado mudou?
+  if (verse_visible == verse_was_visible)
+    return;
 
-  // blog(LOG_INFO, "[Auto Hide DEBUG] JSON Recebido: %s", raw_data.left(500).toUtf8().constData());
+  verse_was_visible = verse_visible;
 
+  log(LogLevel::Info, "[Auto Hide] Estado mudou: Versículo %s (Type detectado via JSON)",
+      verse_visible ? "VISÍVEL" : "OCULTO");
 
+  // Notificar callback
+  if (on_verse_changed) {
+    TransitionTrace trace = current_trace;
+    trace.detected_ns = os_gettime_ns();
+    on_verse_changed(verse_visible, trace);
+  }
+}
 
-  if (root.contains("map")) {
+bool HolyricsClient::detect_verse(const QByteArray &raw_data) {
+  // Caminho rápido: lê map.type/map.text direto dos bytes, sem QJsonDocument
+  HolyricsView view;
+  if (scan_holyrics_view(raw_data, view) != ScanStatus::Complete) {
+    // Payload incomum: usa o parser completo
+    return detect_verse_json(raw_data);
+  }
 
-      QJsonObject map = root.value("map").toObject();
+  if (!view.has_map) {
+    log(LogLevel::Debug, "[Auto Hide DEBUG] JSON não contém chave 'map'.");
+    return false;
+  }
 
-            if (map.contains("type")) {
+  if (!view.has_type) {
+    log(LogLevel::Debug, "[Auto Hide DEBUG] Objeto 'map' não contém chave 'type'.");
+    return false;
+  }
 
-                QString type = map.value("type").toString();
+  const QString type = QString::fromUtf8(view.type);
+  const ContentAction action = content_rules.action_for(type);
+  enter_content(type, action);
+  if (action != ContentAction::HideIfText)
+    return verse_for_action(action);
+
+  // Verificar se há texto real (direto nos bytes, sem materializar o HTML)
+  if (view.has_text && html_text_is_blank(view.text, view.text_has_escapes)) {
+    log(LogLevel::Debug, "[Auto Hide DEBUG] Tipo é %s, mas texto está vazio (F9?) -> Ignorando.",
+        type.toUtf8().constData());
+    return false;
+  }
 
-                blog(LOG_INFO, "[Auto Hide DEBUG] Tipo detectado: '%s'", type.toUtf8().constData());
+  return true;
+}
 
-                if (type.compare("MUSIC", Qt::CaseInsensitive) == 0) {
-                    if (on_deactivation_requested && disable_in_music) {
-                        on_deactivation_requested();
-                        return true;
-                    }
-                    return true;
-                }
+bool HolyricsClient::detect_verse_partial(const QByteArray &received) {
+  HolyricsView view;
+  // Completo ou inválido: deixa para o caminho normal no fim da resposta
+  if (scan_holyrics_view(received, view) != ScanStatus::Truncated ||
+      !view.has_type)
+    return false;
+
+  const QString type = QString::fromUtf8(view.type);
+  const ContentAction action = content_rules.action_for(type);
+  if (action == ContentAction::HideIfText) {
+    if (!view.has_text)
+      return false;
 
-                bool is_bible = type.compare("BIBLE", Qt::CaseInsensitive) == 0;
-                if (!is_bible) return false;
+    bool visible;
+    if (view.text_complete) {
+      visible = !html_text_is_blank(view.text, view.text_has_escapes);
+    } else if (html_text_prefix_has_visible(view.text, view.text_has_escapes)) {
+      visible = true;
+    } else {
+      // Texto em branco até aqui: precisa de mais bytes
+      return false;
+    }
 
-                // Verificar se há texto real (ignorando tags HTML)
-                if (map.contains("text")) {
-                    QString text = map.value("text").toString();
-                    // Remover tags HTML (<...>)
-                    static QRegularExpression html_tag_re("<[^>]*>");
-                    QString plain_text = text.replace(html_tag_re, "");
-                    
-                    // Remover entidades comuns que podem sobrar
-                    plain_text.replace("&nbsp;", " ", Qt::CaseInsensitive);
-                    
-                    if (plain_text.trimmed().isEmpty()) {
-                         blog(LOG_INFO, "[Auto Hide DEBUG] Tipo é BIBLE, mas texto está vazio (F9?) -> Ignorando.");
-                         return false;
-                    }
-                }
-                
-                return true;
+    enter_content(type, action);
+    if (!visible) {
+      log(LogLevel::Debug, "[Auto Hide DEBUG] Tipo é %s, mas texto está vazio (F9?) -> Ignorando.",
+          type.toUtf8().constData());
+    }
+    apply_verse_state(visible);
+    return true;
+  }
 
-            } else {
+  // Os outros perfis decidem só pelo "type"
+  enter_content(type, action);
+  apply_verse_state(verse_for_action(action));
+  return true;
+}
 
-          blog(LOG_WARNING, "[Auto Hide DEBUG] Objeto 'map' não contém chave 'type'.");
+bool HolyricsClient::detect_verse_json(const QByteArray &raw_data) {
+  QJsonDocument doc = QJsonDocument::fromJson(raw_data);
 
-      }
+  if (doc.isNull()) {
+      log(LogLevel::Warning, "[Auto Hide DEBUG] JSON inválido ou vazio.");
+      return false;
+  }
 
-  } else {
+  if (!doc.isObject()) {
+      log(LogLevel::Warning, "[Auto Hide DEBUG] JSON não é um objeto raiz.");
+      return false;
+  }
 
-      blog(LOG_WARNING, "[Auto Hide DEBUG] JSON não contém chave 'map'.");
+  QJsonObject root = doc.object();
 
+  if (!root.contains("map")) {
+      log(LogLevel::Debug, "[Auto Hide DEBUG] JSON não contém chave 'map'.");
+      return false;
   }
 
+  QJsonObject map = root.value("map").toObject();
+  if (!map.contains("type")) {
+      log(LogLevel::Debug, "[Auto Hide DEBUG] Objeto 'map' não contém chave 'type'.");
+      return false;
+  }
 
+  const QString type = map.value("type").toString();
+  const ContentAction action = content_rules.action_for(type);
+  enter_content(type, action);
+  if (action != ContentAction::HideIfText)
+    return verse_for_action(action);
+
+  // Verificar se há texto real (ignorando tags HTML)
+  if (map.contains("text") &&
+      html_text_is_blank(map.value("text").toString().toUtf8(), false)) {
+      log(LogLevel::Debug, "[Auto Hide DEBUG] Tipo é %s, mas texto está vazio (F9?) -> Ignorando.",
+          type.toUtf8().constData());
+      return false;
+  }
 
-  return false;
+  return true;
+}
 
+void HolyricsClient::enter_content(const QString &type, ContentAction action) {
+  log(LogLevel::Debug, "[Auto Hide DEBUG] Tipo detectado: '%s' -> %s",
+      type.toUtf8().constData(), content_action_name(action));
+
+  // Mesmo perfil da resposta anterior: nada de novo a disparar
+  const ContentAction previous = std::exchange(last_action, action);
+  if (action == previous)
+    return;
+
+  if (action == ContentAction::Deactivate && on_deactivation_requested)
+    on_deactivation_requested();
+}
+
+bool HolyricsClient::verse_for_action(ContentAction action) const {
+  switch (action) {
+  case ContentAction::Hide:
+  case ContentAction::HideIfText:
+  case ContentAction::Deactivate:
+    return true;
+  case ContentAction::Keep:
+    return verse_was_visible;
+  case ContentAction::Show:
+    break;
+  }
+  return false;
 }
 
-void HolyricsClient::log(const char *format, ...) {
+void HolyricsClient::log(LogLevel level, const char *format, ...) {
   va_list args;
   va_start(args, format);
-  blog(LOG_INFO, format, args);
+  PluginLog::write_va(level, format, args);
   va_end(args);
 }
@@ -1,10 +1,17 @@
 #pragma once
 
+#include "content-rules.hpp"
+#include "endpoint-failover.hpp"
+#include "feed-trace.hpp"
+#include "plugin-log.hpp"
 #include "presentation-client.hpp"
+#include "request-pipeline.hpp"
+#include "status-stream.hpp"
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QObject>
 #include <QTimer>
+#include <atomic>
 
 class HolyricsClient : public QObject, public IPresentationClient {
   Q_OBJECT
@@ -16,26 +23,84 @@ public:
   void connect(const QString &url) override;
   void disconnect() override;
   bool is_connected() override;
+  void set_poll_scheduler(PollScheduler *scheduler) override;
+  void set_backup_urls(const QStringList &urls) override;
 
   // Configuração
   void set_polling_interval(int ms);
-  void set_disable_in_music(bool disable);
+  // Tabela compilada tipo → perfil (inclui a opção "pausar na música")
+  void set_content_rules(const ContentRuleTable &rules);
+  // Push: mantém uma conexão longa no caminho de stream configurado
+  void set_push_mode(bool enabled);
 
-private slots:
-  void check_view();
-  void on_network_reply_finished();
+  // Transporte HTTP do polling (QNetworkAccessManager ou keep-alive)
+  void set_transport(PipelineTransport transport);
+
+  // Contadores de polling (consultas puladas por conteúdo igual)
+  const PollStats &poll_stats() const { return pipeline->stats(); }
+
+  // Gravação do feed: um trace novo a cada connect() no diretório dado
+  // (vazio = desligado)
+  void set_trace_capture(const QString &directory);
+  // Reprodução: entrega um corpo gravado como se tivesse acabado de chegar
+  void feed_recorded(TraceSource source, const QByteArray &body);
+  void set_stream_path(const QString &path);
+  // Endpoint com a playlist / próximo item (vazio = sem pré-armar)
+  void set_next_item_path(const QString &path);
 
 private:
   QNetworkAccessManager *network_manager;
-  QTimer polling_timer;
+  RequestPipeline *pipeline;
+  EndpointFailover *failover;
+  QStringList backup_urls;
+  RequestPipeline *next_item_pipeline;
+  StatusStream *status_stream;
+  QTimer stream_retry_timer;
+  bool push_mode = false;
+  QString stream_path;
+  QString next_item_path;
+  bool upcoming_verse = false;
   QString base_url;
-  bool connected = false;
+  std::atomic<bool> connected{false};
   bool verse_was_visible = false;
+  bool reachable = false;
+  ConnectionState connection_state = ConnectionState::Connected;
   int polling_interval_ms = 1000;
-  bool disable_in_music = false; // Novo: Configuração para música
+  ContentRuleTable content_rules;
+  // Ação do último tipo visto: as ações de borda disparam só na entrada
+  ContentAction last_action = ContentAction::Show;
+
+  bool detect_verse(const QByteArray &raw_data);
+  // Decisão antecipada sobre o corpo ainda incompleto (true = decidido)
+  bool detect_verse_partial(const QByteArray &received);
+  // Fallback com QJsonDocument para payloads fora do formato esperado
+  bool detect_verse_json(const QByteArray &raw_data);
+  // Loga o tipo e dispara a ação de borda (desativação) ao entrar nele
+  void enter_content(const QString &type, ContentAction action);
+  bool verse_for_action(ContentAction action) const;
+  void apply_verse_state(bool verse_visible);
+  // Próximo item (pré-armar)
+  void start_next_item_polling();
+  void update_upcoming(const QByteArray &data);
+  void set_upcoming(bool value);
+  void set_reachable(bool value);
+  void set_connection_state(ConnectionState state);
+  // Failover: mesma sessão, só a URL base muda
+  void switch_endpoint(const QString &url);
+
+  // Latência: momentos da resposta em avaliação
+  TransitionTrace current_trace;
+  void begin_trace(uint64_t request_sent_ns, uint64_t response_ns);
+
+  // Trace do feed
+  FeedTraceWriter trace_writer;
+  QString trace_directory;
+  void start_trace_capture();
 
-  bool detect_verse(const QString &html);
+  // Push mode
+  void open_stream();
+  void on_stream_dropped(const QString &reason);
 
-  // Logging helper
-  void log(const char *format, ...);
+  // Logging helper (PluginLog: nível configurável e rate limit)
+  void log(LogLevel level, const char *format, ...);
 };
@@ -0,0 +1,466 @@
+#include "json-scanner.hpp"
+#include <QVarLengthArray>
+#include <QtAlgorithms>
+#include <simde/x86/sse2.h>
+
+namespace {
+
+struct Cursor {
+  const char *p;
+  const char *end;
+};
+
+// Próximo '"' ou '\\' a partir de p (16 bytes por iteração)
+const char *find_quote_or_escape(const char *p, const char *end) {
+  const simde__m128i quote = simde_mm_set1_epi8('"');
+  const simde__m128i backslash = simde_mm_set1_epi8('\\');
+
+  while (end - p >= 16) {
+    simde__m128i chunk =
+        simde_mm_loadu_si128(reinterpret_cast<const simde__m128i *>(p));
+    simde__m128i hits = simde_mm_or_si128(simde_mm_cmpeq_epi8(chunk, quote),
+                                          simde_mm_cmpeq_epi8(chunk, backslash));
+    int mask = simde_mm_movemask_epi8(hits);
+    if (mask)
+      return p + qCountTrailingZeroBits(static_cast<quint32>(mask));
+    p += 16;
+  }
+
+  for (; p < end; ++p) {
+    if (*p == '"' || *p == '\\')
+      return p;
+  }
+  return end;
+}
+
+// Próximo '"', '{', '}', '[' ou ']' a partir de p.
+// '[' | 0x20 == '{' e ']' | 0x20 == '}', então duas comparações cobrem os
+// quatro delimitadores.
+const char *find_structural(const char *p, const char *end) {
+  const simde__m128i quote = simde_mm_set1_epi8('"');
+  const simde__m128i case_bit = simde_mm_set1_epi8(0x20);
+  const simde__m128i open = simde_mm_set1_epi8('{');
+  const simde__m128i close = simde_mm_set1_epi8('}');
+
+  while (end - p >= 16) {
+    simde__m128i chunk =
+        simde_mm_loadu_si128(reinterpret_cast<const simde__m128i *>(p));
+    simde__m128i folded = simde_mm_or_si128(chunk, case_bit);
+    simde__m128i hits = simde_mm_or_si128(
+        simde_mm_cmpeq_epi8(chunk, quote),
+        simde_mm_or_si128(simde_mm_cmpeq_epi8(folded, open),
+                          simde_mm_cmpeq_epi8(folded, close)));
+    int mask = simde_mm_movemask_epi8(hits);
+    if (mask)
+      return p + qCountTrailingZeroBits(static_cast<quint32>(mask));
+    p += 16;
+  }
+
+  for (; p < end; ++p) {
+    char c = *p;
+    if (c == '"' || c == '{' || c == '}' || c == '[' || c == ']')
+      return p;
+  }
+  return end;
+}
+
+char peek(const Cursor &c) { return c.p < c.end ? *c.p : '\0'; }
+
+void skip_ws(Cursor &c) {
+  while (c.p < c.end &&
+         (*c.p == ' ' || *c.p == '\n' || *c.p == '\r' || *c.p == '\t'))
+    ++c.p;
+}
+
+// Convenção: toda falha por falta de bytes deixa c.p == c.end, o que
+// permite distinguir documento truncado de documento inválido.
+
+// c.p na aspa de abertura; termina logo após a aspa de fechamento
+bool skip_string(Cursor &c, bool *has_escapes) {
+  ++c.p;
+  while (true) {
+    const char *hit = find_quote_or_escape(c.p, c.end);
+    if (hit == c.end) {
+      c.p = c.end;
+      return false;
+    }
+    if (*hit == '\\') {
+      if (has_escapes)
+        *has_escapes = true;
+      c.p = hit + 2;
+      if (c.p >= c.end) {
+        c.p = c.end;
+        return false;
+      }
+      continue;
+    }
+    c.p = hit + 1;
+    return true;
+  }
+}
+
+// c.p em '{' ou '['; termina logo após o delimitador correspondente.
+// Fechamento trocado ("{]") é inválido (c.p fica no delimitador).
+bool skip_container(Cursor &c) {
+  // Fechamentos esperados, do mais externo ao mais interno
+  QVarLengthArray<char, 32> closers;
+  while (true) {
+    const char *hit = find_structural(c.p, c.end);
+    c.p = hit;
+    if (hit == c.end)
+      return false;
+    if (*hit == '"') {
+      if (!skip_string(c, nullptr))
+        return false;
+      continue;
+    }
+    if (*hit == '{' || *hit == '[') {
+      closers.append(*hit == '{' ? '}' : ']');
+    } else {
+      if (closers.isEmpty() || closers.back() != *hit)
+        return false;
+      closers.removeLast();
+    }
+    ++c.p;
+    if (closers.isEmpty())
+      return true;
+  }
+}
+
+// Número, true, false ou null. Token vazio ou fora desse formato é
+// inválido; cortado pelo fim do buffer, truncado (c.p == c.end).
+bool skip_scalar(Cursor &c) {
+  const char *begin = c.p;
+  while (c.p < c.end && *c.p != ',' && *c.p != '}' && *c.p != ']' &&
+         *c.p != ' ' && *c.p != '\n' && *c.p != '\r' && *c.p != '\t')
+    ++c.p;
+  if (c.p == c.end)
+    return false;
+
+  const QByteArrayView token(begin, c.p - begin);
+  if (token == "true" || token == "false" || token == "null")
+    return true;
+  if (token.isEmpty() || (token[0] != '-' && (token[0] < '0' || token[0] > '9')))
+    return false;
+  for (char ch : token) {
+    if ((ch < '0' || ch > '9') && ch != '-' && ch != '+' && ch != '.' &&
+        ch != 'e' && ch != 'E')
+      return false;
+  }
+  return true;
+}
+
+bool skip_value(Cursor &c) {
+  skip_ws(c);
+  switch (peek(c)) {
+  case '\0':
+    return false;
+  case '"':
+    return skip_string(c, nullptr);
+  case '{':
+  case '[':
+    return skip_container(c);
+  default:
+    return skip_scalar(c);
+  }
+}
+
+// Percorre os membros de um objeto (c.p em '{'). on_member recebe a chave
+// e deve consumir o valor, retornando false em caso de erro.
+template <typename F> bool for_each_member(Cursor &c, F &&on_member) {
+  if (peek(c) != '{')
+    return false;
+  ++c.p;
+
+  skip_ws(c);
+  if (peek(c) == '}') {
+    ++c.p;
+    return true;
+  }
+
+  while (true) {
+    skip_ws(c);
+    if (peek(c) != '"')
+      return false;
+
+    const char *key_begin = c.p + 1;
+    if (!skip_string(c, nullptr))
+      return false;
+    QByteArrayView key(key_begin, c.p - 1 - key_begin);
+
+    skip_ws(c);
+    if (peek(c) != ':')
+      return false;
+    ++c.p;
+    skip_ws(c);
+
+    if (!on_member(key, c))
+      return false;
+
+    skip_ws(c);
+    char next = peek(c);
+    if (next == ',') {
+      ++c.p;
+      continue;
+    }
+    if (next == '}') {
+      ++c.p;
+      return true;
+    }
+    return false;
+  }
+}
+
+// Leitor de code points sobre UTF-8, opcionalmente resolvendo escapes JSON
+struct CodePointReader {
+  const unsigned char *p;
+  const unsigned char *end;
+  bool json_escaped;
+
+  static constexpr char32_t kEnd = 0xFFFFFFFF;
+  static constexpr char32_t kInvalid = 0xFFFD;
+  // Escape ou sequência UTF-8 cortada pelo fim do buffer
+  static constexpr char32_t kTruncated = 0xFFFFFFFE;
+
+  static int hex_value(unsigned char c) {
+    if (c >= '0' && c <= '9')
+      return c - '0';
+    if (c >= 'a' && c <= 'f')
+      return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+      return c - 'A' + 10;
+    return -1;
+  }
+
+  char32_t next() {
+    if (p >= end)
+      return kEnd;
+
+    unsigned char c = *p++;
+
+    if (json_escaped && c == '\\') {
+      if (p >= end)
+        return kTruncated;
+      unsigned char e = *p++;
+      switch (e) {
+      case 'n':
+        return '\n';
+      case 'r':
+        return '\r';
+      case 't':
+        return '\t';
+      case 'b':
+        return '\b';
+      case 'f':
+        return '\f';
+      case 'u': {
+        if (end - p < 4)
+          return kTruncated;
+        char32_t cp = 0;
+        for (int i = 0; i < 4; i++) {
+          int v = hex_value(p[i]);
+          if (v < 0)
+            return kInvalid;
+          cp = (cp << 4) | static_cast<char32_t>(v);
+        }
+        p += 4;
+        return cp; // Surrogates contam como visíveis, o que basta aqui
+      }
+      default:
+        return e; // \" \\ \/
+      }
+    }
+
+    if (c < 0x80)
+      return c;
+
+    int extra = (c >= 0xF0) ? 3 : (c >= 0xE0) ? 2 : (c >= 0xC0) ? 1 : -1;
+    if (extra < 0)
+      return kInvalid;
+    if (end - p < extra)
+      return kTruncated;
+
+    char32_t cp = c & (0x3F >> extra);
+    for (int i = 0; i < extra; i++) {
+      cp = (cp << 6) | (*p++ & 0x3F);
+    }
+    return cp;
+  }
+};
+
+// Mesmo critério de QChar::isSpace (categorias Zs/Zl/Zp e controles)
+bool is_space(char32_t cp) {
+  if (cp <= 0x20)
+    return cp == ' ' || (cp >= '\t' && cp <= '\r');
+  switch (cp) {
+  case 0x85:
+  case 0xA0:
+  case 0x1680:
+  case 0x2028:
+  case 0x2029:
+  case 0x202F:
+  case 0x205F:
+  case 0x3000:
+    return true;
+  default:
+    return cp >= 0x2000 && cp <= 0x200A;
+  }
+}
+
+char32_t to_lower_ascii(char32_t cp) {
+  return (cp >= 'A' && cp <= 'Z') ? cp + ('a' - 'A') : cp;
+}
+
+// Undecided: só em trecho incompleto, quando o fim cai dentro de uma
+// entidade, escape ou caractere UTF-8 (o que vem depois pode ser espaço)
+enum class HtmlTextScan { Blank, Visible, OpenTag, Undecided };
+
+HtmlTextScan scan_html_text(QByteArrayView text, bool json_escaped,
+                            bool prefix) {
+  CodePointReader reader{
+      reinterpret_cast<const unsigned char *>(text.data()),
+      reinterpret_cast<const unsigned char *>(text.data()) + text.size(),
+      json_escaped};
+
+  bool in_tag = false;
+
+  while (true) {
+    char32_t cp = reader.next();
+    if (cp == CodePointReader::kEnd)
+      break;
+    if (cp == CodePointReader::kTruncated) {
+      // Documento completo: sequência quebrada conta como texto, igual
+      // ao decodificador do Qt
+      if (prefix)
+        return HtmlTextScan::Undecided;
+      cp = CodePointReader::kInvalid;
+    }
+
+    if (in_tag) {
+      if (cp == '>')
+        in_tag = false;
+      continue;
+    }
+
+    if (cp == '<') {
+      in_tag = true;
+      continue;
+    }
+
+    if (cp == '&') {
+      // Só &nbsp; é tratado como espaço; outras entidades são texto
+      CodePointReader lookahead = reader;
+      static const char entity[] = "nbsp;";
+      bool is_nbsp = true;
+      for (const char *e = entity; *e; ++e) {
+        const char32_t next = lookahead.next();
+        if (prefix && (next == CodePointReader::kEnd ||
+                       next == CodePointReader::kTruncated))
+          return HtmlTextScan::Undecided; // "&nb" cortado: ainda pode ser &nbsp;
+        if (to_lower_ascii(next) != static_cast<char32_t>(*e)) {
+          is_nbsp = false;
+          break;
+        }
+      }
+      if (!is_nbsp)
+        return HtmlTextScan::Visible;
+      reader = lookahead;
+      continue;
+    }
+
+    if (!is_space(cp))
+      return HtmlTextScan::Visible;
+  }
+
+  return in_tag ? HtmlTextScan::OpenTag : HtmlTextScan::Blank;
+}
+
+} // namespace
+
+bool html_text_is_blank(QByteArrayView text, bool json_escaped) {
+  // Tag sem '>' não é removida pela regex original: o '<' fica visível
+  return scan_html_text(text, json_escaped, false) == HtmlTextScan::Blank;
+}
+
+bool html_text_prefix_has_visible(QByteArrayView text, bool json_escaped) {
+  // Visible só para um code point decodificado por inteiro antes do corte
+  return scan_html_text(text, json_escaped, true) == HtmlTextScan::Visible;
+}
+
+ScanStatus scan_holyrics_view(QByteArrayView json, HolyricsView &view) {
+  view = HolyricsView();
+
+  Cursor c{json.data(), json.data() + json.size()};
+  skip_ws(c);
+
+  auto on_map_member = [&view](QByteArrayView key, Cursor &c) {
+    if (key == "type") {
+      if (peek(c) != '"')
+        return false; // type não-string: deixa o fallback decidir
+      const char *begin = c.p + 1;
+      bool escaped = false;
+      if (!skip_string(c, &escaped) || escaped)
+        return false;
+      view.has_type = true;
+      view.type = QByteArrayView(begin, c.p - 1 - begin);
+      return true;
+    }
+    if (key == "text" && peek(c) == '"') {
+      // Só registra onde está: o HTML não é materializado aqui
+      const char *begin = c.p + 1;
+      bool escaped = false;
+      bool complete = skip_string(c, &escaped);
+      if (!complete && c.p != c.end)
+        return false;
+      view.has_text = true;
+      view.text = complete ? QByteArrayView(begin, c.p - 1 - begin)
+                           : QByteArrayView(begin, c.end - begin);
+      view.text_has_escapes = escaped;
+      view.text_complete = complete;
+      return complete;
+    }
+    return skip_value(c);
+  };
+
+  auto on_root_member = [&view, &on_map_member](QByteArrayView key,
+                                                Cursor &c) {
+    if (key == "map") {
+      if (peek(c) != '{')
+        return false;
+      view.has_map = true;
+      return for_each_member(c, on_map_member);
+    }
+    return skip_value(c);
+  };
+
+  if (!for_each_member(c, on_root_member))
+    return c.p >= c.end ? ScanStatus::Truncated : ScanStatus::Invalid;
+
+  skip_ws(c);
+  return c.p == c.end ? ScanStatus::Complete : ScanStatus::Invalid;
+}
+
+ScanStatus scan_presentation_active(QByteArrayView json,
+                                    PresentationActiveView &view) {
+  view = PresentationActiveView();
+
+  Cursor c{json.data(), json.data() + json.size()};
+  skip_ws(c);
+
+  auto on_root_member = [&view](QByteArrayView key, Cursor &c) {
+    if (key == "presentation") {
+      if (c.p >= c.end)
+        return false;
+      // O primeiro byte do valor já basta para decidir
+      view.has_presentation = true;
+      view.presentation_null = (peek(c) == 'n');
+    }
+    return skip_value(c);
+  };
+
+  if (!for_each_member(c, on_root_member))
+    return c.p >= c.end ? ScanStatus::Truncated : ScanStatus::Invalid;
+
+  skip_ws(c);
+  return c.p == c.end ? ScanStatus::Complete : ScanStatus::Invalid;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <QByteArray>
+#include <QByteArrayView>
+
+// Varreduras em passada única (SSE2 via SIMDe) sobre os bytes UTF-8 das
+// respostas, sem montar QJsonDocument. As views apontam para o buffer
+// original (nada é copiado): só são válidas enquanto o QByteArray existir.
+
+enum class ScanStatus {
+  Complete,  // Documento inteiro lido
+  Truncated, // Faltam bytes (resposta ainda chegando): campos parciais valem
+  Invalid    // Fora do formato esperado: usar o parser completo
+};
+
+// Campos de /view/text.json (Holyrics) usados na detecção
+struct HolyricsView {
+  bool has_map = false;
+  bool has_type = false;
+  QByteArrayView type;   // Bytes crus do valor de map.type (sem escapes)
+  bool has_text = false;
+  QByteArrayView text;   // Conteúdo entre aspas de map.text, ainda escapado
+  bool text_has_escapes = false;
+  bool text_complete = false; // false: 'text' é só o trecho já recebido
+};
+
+// Encontra map.type e map.text, pulando o resto do documento. Invalid em
+// JSON inválido, 'map' não objeto, escapes em 'type' etc.
+ScanStatus scan_holyrics_view(QByteArrayView json, HolyricsView &view);
+
+// Campo raiz de /v1/presentation/active (ProPresenter)
+struct PresentationActiveView {
+  bool has_presentation = false;
+  bool presentation_null = false;
+};
+
+ScanStatus scan_presentation_active(QByteArrayView json,
+                                    PresentationActiveView &view);
+
+// Equivale a remover tags (<...>) e "&nbsp;" e testar trimmed().isEmpty(),
+// mas sem alocar: percorre os bytes UTF-8 e para no primeiro caractere
+// visível. Com json_escaped, 'text' é o conteúdo cru de uma string JSON
+// (escapes como \" e \u00a0 são resolvidos durante a varredura).
+bool html_text_is_blank(QByteArrayView text, bool json_escaped);
+
+// Para um trecho inicial de texto ainda incompleto: true apenas se já há
+// um caractere visível decodificado por inteiro. Um corte dentro de
+// entidade, escape JSON ou caractere UTF-8 deixa a decisão para depois.
+bool html_text_prefix_has_visible(QByteArrayView text, bool json_escaped);
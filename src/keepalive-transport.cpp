@@ -0,0 +1,378 @@
+#include "keepalive-transport.hpp"
+#include <cstring>
+
+// Tamanho inicial do buffer de recepção (cresce só se uma resposta não couber)
+static constexpr qsizetype kReceiveBufferBytes = 64 * 1024;
+// Limite para o bloco de cabeçalhos
+static constexpr qsizetype kMaxHeaderBytes = 64 * 1024;
+// Espera antes de reabrir a conexão fechada pelo servidor (evita laço
+// apertado com um servidor que fecha toda conexão logo após aceitar)
+static constexpr int kReconnectDelayMs = 100;
+
+KeepAliveTransport::KeepAliveTransport(QObject *parent)
+    : QObject(parent), socket(this), timeout_timer(this),
+      reconnect_timer(this) {
+  receive_buffer.resize(kReceiveBufferBytes);
+
+  timeout_timer.setSingleShot(true);
+  QObject::connect(&timeout_timer, &QTimer::timeout, this,
+                   &KeepAliveTransport::on_timeout);
+
+  reconnect_timer.setSingleShot(true);
+  QObject::connect(&reconnect_timer, &QTimer::timeout, this,
+                   &KeepAliveTransport::warm_up);
+
+  QObject::connect(&socket, &QTcpSocket::connected, this,
+                   &KeepAliveTransport::on_connected);
+  QObject::connect(&socket, &QTcpSocket::readyRead, this,
+                   &KeepAliveTransport::on_ready_read);
+  QObject::connect(&socket, &QTcpSocket::disconnected, this,
+                   &KeepAliveTransport::on_disconnected);
+  QObject::connect(&socket, &QTcpSocket::errorOccurred, this,
+                   &KeepAliveTransport::on_socket_error);
+}
+
+KeepAliveTransport::~KeepAliveTransport() {
+  QObject::disconnect(&socket, nullptr, this, nullptr);
+  socket.abort();
+}
+
+bool KeepAliveTransport::supports(const QUrl &url) {
+  return url.isValid() && url.scheme() == "http";
+}
+
+void KeepAliveTransport::set_url(const QUrl &url) {
+  QString new_host = url.host();
+  quint16 new_port = static_cast<quint16>(url.port(80));
+
+  if (new_host != host || new_port != port) {
+    cancel();
+    socket.abort();
+    host = new_host;
+    port = new_port;
+  }
+
+  QByteArray path = url.path(QUrl::FullyEncoded).toUtf8();
+  if (path.isEmpty())
+    path = "/";
+  if (url.hasQuery())
+    path += "?" + url.query(QUrl::FullyEncoded).toUtf8();
+
+  QByteArray host_header = host.toUtf8();
+  if (port != 80)
+    host_header += ":" + QByteArray::number(port);
+
+  // Serializada uma vez; só o If-None-Match varia por consulta
+  request_head = "GET " + path + " HTTP/1.1\r\n"
+                 "Host: " + host_header + "\r\n"
+                 "User-Agent: OBS Auto Hide Plugin\r\n"
+                 "Accept: */*\r\n"
+                 "Connection: keep-alive\r\n";
+
+  prewarm = true;
+  warm_up();
+}
+
+void KeepAliveTransport::warm_up() {
+  // Conectando/conectado: nada a fazer; a consulta usa a conexão que vier
+  if (!prewarm || host.isEmpty() ||
+      socket.state() != QAbstractSocket::UnconnectedState)
+    return;
+  socket.connectToHost(host, port);
+}
+
+bool KeepAliveTransport::send(quint64 sequence, const QByteArray &etag) {
+  if (busy || host.isEmpty())
+    return false;
+
+  reconnect_timer.stop();
+  busy = true;
+  retried = false;
+  current_sequence = sequence;
+  current_etag = etag;
+  reset_response();
+  timeout_timer.start(transfer_timeout_ms);
+
+  switch (socket.state()) {
+  case QAbstractSocket::ConnectedState:
+    write_request();
+    break;
+  case QAbstractSocket::UnconnectedState:
+    socket.connectToHost(host, port);
+    break;
+  default:
+    // Conectando/fechando: on_connected ou on_disconnected continuam
+    break;
+  }
+  return true;
+}
+
+void KeepAliveTransport::cancel() {
+  if (!busy)
+    return;
+
+  busy = false;
+  timeout_timer.stop();
+  // Resposta pela metade deixaria a conexão dessincronizada
+  socket.abort();
+  used = 0;
+}
+
+void KeepAliveTransport::close() {
+  // Antes do abort: o disconnected emitido não deve reabrir a conexão
+  prewarm = false;
+  reconnect_timer.stop();
+  cancel();
+  socket.abort();
+}
+
+void KeepAliveTransport::write_request() {
+  socket.write(request_head);
+  if (!current_etag.isEmpty()) {
+    socket.write("If-None-Match: ");
+    socket.write(current_etag);
+    socket.write("\r\n");
+  }
+  socket.write("\r\n");
+}
+
+void KeepAliveTransport::on_connected() {
+  socket.setSocketOption(QAbstractSocket::LowDelayOption, 1);
+  socket.setSocketOption(QAbstractSocket::KeepAliveOption, 1);
+  if (busy)
+    write_request();
+}
+
+void KeepAliveTransport::on_ready_read() {
+  while (socket.bytesAvailable() > 0) {
+    if (used == receive_buffer.size())
+      receive_buffer.resize(receive_buffer.size() * 2);
+    qint64 n = socket.read(receive_buffer.data() + used,
+                           receive_buffer.size() - used);
+    if (n <= 0)
+      break;
+    used += n;
+  }
+
+  if (!busy) {
+    // Bytes fora de uma requisição: descarta
+    used = 0;
+    return;
+  }
+
+  if (header_length < 0 && !parse_headers())
+    return;
+  if (!busy)
+    return;
+
+  if (advance_body()) {
+    finish();
+  } else if (busy && on_progress) {
+    on_progress(current_sequence,
+                QByteArrayView(receive_buffer.constData() + header_length,
+                               body_length));
+  }
+}
+
+void KeepAliveTransport::on_disconnected() {
+  if (!busy) {
+    // Conexão ociosa fechada (pelo servidor, ou abortada após uma resposta
+    // com "Connection: close"/falha): reabre antes da próxima consulta
+    if (prewarm)
+      reconnect_timer.start(kReconnectDelayMs);
+    return;
+  }
+
+  // Sem Content-Length nem chunked: o corpo termina no fechamento
+  if (header_length >= 0 && content_length < 0 && !chunked) {
+    finish();
+    return;
+  }
+
+  // Servidor fechou a conexão ociosa antes de responder: reconecta uma vez
+  if (used == 0 && !retried) {
+    retried = true;
+    reset_response();
+    socket.connectToHost(host, port);
+    return;
+  }
+
+  fail("Conexão encerrada pelo servidor");
+}
+
+void KeepAliveTransport::on_socket_error(QAbstractSocket::SocketError error) {
+  // Fechamento remoto é tratado em on_disconnected
+  if (error == QAbstractSocket::RemoteHostClosedError || !busy)
+    return;
+  fail(socket.errorString());
+}
+
+void KeepAliveTransport::on_timeout() { fail("Tempo limite excedido"); }
+
+void KeepAliveTransport::reset_response() {
+  used = 0;
+  header_length = -1;
+  status_code = 0;
+  content_length = -1;
+  chunked = false;
+  close_after = false;
+  response_etag.clear();
+  chunk_read_pos = 0;
+  body_length = 0;
+}
+
+bool KeepAliveTransport::parse_headers() {
+  QByteArrayView received(receive_buffer.constData(), used);
+  qsizetype end = received.indexOf("\r\n\r\n");
+  if (end < 0) {
+    if (used > kMaxHeaderBytes)
+      fail("Cabeçalho HTTP grande demais");
+    return false;
+  }
+
+  header_length = end + 4;
+  QByteArrayView head = received.first(end);
+
+  qsizetype line_end = head.indexOf("\r\n");
+  QByteArrayView status_line = line_end < 0 ? head : head.first(line_end);
+
+  // "HTTP/1.1 200 OK"
+  qsizetype space = status_line.indexOf(' ');
+  if (!status_line.startsWith("HTTP/") || space < 0) {
+    fail("Resposta HTTP inválida");
+    return false;
+  }
+  status_code = status_line.sliced(space + 1).first(
+                    qMin<qsizetype>(3, status_line.size() - space - 1))
+                    .toInt();
+  close_after = status_line.startsWith("HTTP/1.0");
+
+  qsizetype pos = line_end < 0 ? head.size() : line_end + 2;
+  while (pos < head.size()) {
+    qsizetype next = head.indexOf("\r\n", pos);
+    QByteArrayView line =
+        head.sliced(pos, (next < 0 ? head.size() : next) - pos);
+    pos = next < 0 ? head.size() : next + 2;
+
+    qsizetype colon = line.indexOf(':');
+    if (colon <= 0)
+      continue;
+    QByteArrayView name = line.first(colon);
+    QByteArrayView value = line.sliced(colon + 1).trimmed();
+
+    if (name.compare("Content-Length", Qt::CaseInsensitive) == 0) {
+      content_length = value.toLongLong();
+    } else if (name.compare("Transfer-Encoding", Qt::CaseInsensitive) == 0) {
+      chunked = value.toByteArray().toLower().contains("chunked");
+    } else if (name.compare("Connection", Qt::CaseInsensitive) == 0) {
+      QByteArray connection = value.toByteArray().toLower();
+      if (connection.contains("close"))
+        close_after = true;
+      else if (connection.contains("keep-alive"))
+        close_after = false;
+    } else if (name.compare("ETag", Qt::CaseInsensitive) == 0) {
+      response_etag = value.toByteArray();
+    }
+  }
+
+  // Respostas sem corpo
+  if (status_code == 304 || status_code == 204 ||
+      (status_code >= 100 && status_code < 200)) {
+    content_length = 0;
+    chunked = false;
+  }
+
+  chunk_read_pos = header_length;
+  body_length = 0;
+  return true;
+}
+
+bool KeepAliveTransport::advance_body() {
+  if (!chunked) {
+    qsizetype available = used - header_length;
+    if (content_length < 0) {
+      // Até o fechamento da conexão
+      body_length = available;
+      return false;
+    }
+    body_length = qMin(available, content_length);
+    return available >= content_length;
+  }
+
+  // Chunked: compacta os dados dos chunks logo após os cabeçalhos, no
+  // próprio buffer (a escrita nunca passa da leitura)
+  char *data = receive_buffer.data();
+  while (true) {
+    QByteArrayView pending(data + chunk_read_pos, used - chunk_read_pos);
+    qsizetype line_end = pending.indexOf("\r\n");
+    if (line_end < 0)
+      return false;
+
+    QByteArrayView size_field = pending.first(line_end);
+    qsizetype extension = size_field.indexOf(';');
+    if (extension >= 0)
+      size_field = size_field.first(extension);
+
+    bool ok = false;
+    qsizetype chunk_size = size_field.trimmed().toLongLong(&ok, 16);
+    if (!ok || chunk_size < 0) {
+      fail("Chunk HTTP inválido");
+      return false;
+    }
+
+    qsizetype data_start = chunk_read_pos + line_end + 2;
+
+    if (chunk_size == 0) {
+      // Último chunk: espera a linha vazia final (após eventuais trailers)
+      qsizetype p = data_start;
+      while (true) {
+        qsizetype crlf =
+            QByteArrayView(data + p, used - p).indexOf("\r\n");
+        if (crlf < 0)
+          return false;
+        if (crlf == 0)
+          return true;
+        p += crlf + 2;
+      }
+    }
+
+    if (used < data_start + chunk_size + 2)
+      return false;
+
+    std::memmove(data + header_length + body_length, data + data_start,
+                 static_cast<size_t>(chunk_size));
+    body_length += chunk_size;
+    chunk_read_pos = data_start + chunk_size + 2;
+  }
+}
+
+void KeepAliveTransport::finish() {
+  timeout_timer.stop();
+  busy = false;
+
+  const quint64 sequence = current_sequence;
+  const int status = status_code;
+  const QByteArray etag = response_etag;
+  QByteArrayView body(receive_buffer.constData() + header_length, body_length);
+
+  // Próxima resposta começa do início do buffer
+  used = 0;
+
+  if (close_after)
+    socket.abort();
+
+  if (on_complete) {
+    on_complete(sequence, status, body, etag);
+  }
+}
+
+void KeepAliveTransport::fail(const QString &error) {
+  timeout_timer.stop();
+  busy = false;
+  socket.abort();
+  used = 0;
+
+  if (on_failed) {
+    on_failed(current_sequence, error);
+  }
+}
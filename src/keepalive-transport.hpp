@@ -0,0 +1,93 @@
+#pragma once
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QObject>
+#include <QString>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QUrl>
+#include <functional>
+
+// Transporte HTTP/1.1 mínimo para o polling: uma única conexão TCP
+// keep-alive pré-aquecida, requisição GET serializada uma vez por URL e
+// buffer de recepção reaproveitado entre consultas. set_url já abre a
+// conexão e, quando o servidor fecha a conexão ociosa, ela é reaberta em
+// segundo plano (a próxima consulta não paga o handshake). close() encerra
+// de vez. Só atende http:// (sem TLS).
+class KeepAliveTransport : public QObject {
+  Q_OBJECT
+
+public:
+  explicit KeepAliveTransport(QObject *parent = nullptr);
+  ~KeepAliveTransport() override;
+
+  static bool supports(const QUrl &url);
+
+  // Também abre a conexão em segundo plano, se ainda não estiver aberta
+  void set_url(const QUrl &url);
+  void set_transfer_timeout(int ms) { transfer_timeout_ms = ms; }
+
+  // Envia a requisição. etag vazio = sem If-None-Match.
+  // O número de sequência volta nos callbacks.
+  bool send(quint64 sequence, const QByteArray &etag);
+  // Descarta a resposta em andamento (fecha a conexão se estava no meio)
+  void cancel();
+  // Fecha a conexão e para de reconectar até o próximo set_url
+  void close();
+  bool is_busy() const { return busy; }
+
+  // Views apontam para o buffer interno: válidas só durante o callback
+  std::function<void(quint64 sequence, QByteArrayView body_so_far)>
+      on_progress;
+  std::function<void(quint64 sequence, int status, QByteArrayView body,
+                     const QByteArray &etag)>
+      on_complete;
+  std::function<void(quint64 sequence, const QString &error)> on_failed;
+
+private:
+  QTcpSocket socket;
+  QTimer timeout_timer;
+  QTimer reconnect_timer;
+  QString host;
+  quint16 port = 80;
+  QByteArray request_head; // "GET ... HTTP/1.1\r\nHost: ...\r\n..." sem o \r\n final
+  int transfer_timeout_ms = 2000;
+  // Mantém a conexão aberta entre as consultas (desligado por close())
+  bool prewarm = false;
+
+  // Estado da requisição atual
+  bool busy = false;
+  bool retried = false;
+  quint64 current_sequence = 0;
+  QByteArray current_etag;
+
+  // Buffer fixo de recepção
+  QByteArray receive_buffer;
+  qsizetype used = 0;
+
+  // Estado do parser da resposta
+  qsizetype header_length = -1;
+  int status_code = 0;
+  qsizetype content_length = -1;
+  bool chunked = false;
+  bool close_after = false;
+  QByteArray response_etag;
+  qsizetype chunk_read_pos = 0;
+  qsizetype body_length = 0;
+
+  void warm_up();
+  void write_request();
+  void on_connected();
+  void on_ready_read();
+  void on_disconnected();
+  void on_socket_error(QAbstractSocket::SocketError error);
+  void on_timeout();
+
+  void reset_response();
+  bool parse_headers();
+  // Retorna true quando o corpo está completo
+  bool advance_body();
+  void finish();
+  void fail(const QString &error);
+};
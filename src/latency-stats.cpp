@@ -0,0 +1,96 @@
+#include "latency-stats.hpp"
+#include <algorithm>
+
+int LatencyHistogram::bucket_index(uint64_t us) {
+  if (us < kSubBuckets)
+    return static_cast<int>(us);
+
+  // Posição do bit mais alto: define a potência de 2 do bucket
+  int exponent = 63;
+  while (!(us >> exponent))
+    exponent--;
+
+  int shift = exponent - kSubBucketBits;
+  int sub_bucket = static_cast<int>((us >> shift) & (kSubBuckets - 1));
+  int index = (shift + 1) * kSubBuckets + sub_bucket;
+  return std::min(index, kBuckets - 1);
+}
+
+uint64_t LatencyHistogram::bucket_upper_bound(int index) {
+  if (index < kSubBuckets)
+    return static_cast<uint64_t>(index);
+
+  int shift = index / kSubBuckets - 1;
+  uint64_t lower = static_cast<uint64_t>(kSubBuckets + index % kSubBuckets)
+                   << shift;
+  return lower + (uint64_t(1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t us) {
+  buckets[bucket_index(us)]++;
+  total++;
+  max_us = std::max(max_us, us);
+}
+
+uint64_t LatencyHistogram::percentile(double p) const {
+  if (total == 0)
+    return 0;
+
+  // Posição (1-based) da amostra do percentil
+  uint64_t rank = static_cast<uint64_t>(p / 100.0 * total + 0.5);
+  rank = std::clamp<uint64_t>(rank, 1, total);
+
+  uint64_t seen = 0;
+  for (int i = 0; i < kBuckets; i++) {
+    seen += buckets[i];
+    if (seen >= rank)
+      return std::min(bucket_upper_bound(i), max_us);
+  }
+  return max_us;
+}
+
+void LatencyHistogram::reset() {
+  buckets.fill(0);
+  total = 0;
+  max_us = 0;
+}
+
+static uint64_t elapsed_us(uint64_t from_ns, uint64_t to_ns) {
+  return to_ns > from_ns ? (to_ns - from_ns) / 1000 : 0;
+}
+
+void LatencyStats::record(const TransitionTrace &trace) {
+  if (!trace.is_valid())
+    return;
+
+  const uint64_t start = trace.request_sent_ns;
+  const uint64_t stage_ns[] = {trace.response_received_ns, trace.detected_ns,
+                               trace.timer_fired_ns, trace.applied_ns};
+
+  for (int i = 0; i < static_cast<int>(LatencyStage::Count); i++) {
+    // Etapa não marcada (ex: transição sem timer): não entra na conta
+    if (stage_ns[i] != 0)
+      histograms[i].record(elapsed_us(start, stage_ns[i]));
+  }
+
+  if (trace.applied_ns != 0) {
+    recent[recent_next] = elapsed_us(start, trace.applied_ns);
+    recent_next = (recent_next + 1) % kRecentSamples;
+    recent_count = std::min(recent_count + 1, kRecentSamples);
+  }
+}
+
+uint64_t LatencyStats::worst_recent_us() const {
+  uint64_t worst = 0;
+  for (int i = 0; i < recent_count; i++)
+    worst = std::max(worst, recent[i]);
+  return worst;
+}
+
+void LatencyStats::reset() {
+  for (LatencyHistogram &histogram : histograms)
+    histogram.reset();
+  recent.fill(0);
+  recent_next = 0;
+  recent_count = 0;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// Momentos (os_gettime_ns) de uma transição, da consulta que trouxe o
+// slide novo até a visibilidade da fonte mudar no OBS
+struct TransitionTrace {
+  uint64_t request_sent_ns = 0;      // Consulta enviada (push: mensagem chegou)
+  uint64_t response_received_ns = 0; // Bytes que decidiram o estado chegaram
+  uint64_t detected_ns = 0;          // Cliente detectou a mudança
+  uint64_t timer_fired_ns = 0;       // Filtro de versículo confirmou
+  uint64_t applied_ns = 0;           // obs_sceneitem_set_visible aplicado
+
+  bool is_valid() const { return request_sent_ns != 0; }
+};
+
+// Etapas medidas, todas a partir do envio da consulta
+enum class LatencyStage { Response, Detection, TimerFired, Applied, Count };
+
+// Histograma log-linear de memória fixa (8 sub-buckets por potência de 2,
+// erro relativo <= 12,5%), em microssegundos
+class LatencyHistogram {
+public:
+  void record(uint64_t us);
+  // Limite superior do bucket que contém o percentil p (0-100)
+  uint64_t percentile(double p) const;
+  uint64_t count() const { return total; }
+  uint64_t max() const { return max_us; }
+  void reset();
+
+private:
+  static constexpr int kSubBucketBits = 3;
+  static constexpr int kSubBuckets = 1 << kSubBucketBits;
+  // Até 2^32 us (~71 min); valores maiores caem no último bucket
+  static constexpr int kBuckets = (32 - kSubBucketBits + 1) * kSubBuckets;
+
+  std::array<uint32_t, kBuckets> buckets{};
+  uint64_t total = 0;
+  uint64_t max_us = 0;
+
+  static int bucket_index(uint64_t us);
+  static uint64_t bucket_upper_bound(int index);
+};
+
+// Histogramas por etapa + amostras fim-a-fim recentes. Usado só na thread
+// da UI (onde a transição termina).
+class LatencyStats {
+public:
+  void record(const TransitionTrace &trace);
+
+  const LatencyHistogram &histogram(LatencyStage stage) const {
+    return histograms[static_cast<int>(stage)];
+  }
+  // Pior latência fim-a-fim (envio -> aplicado) entre as últimas transições
+  uint64_t worst_recent_us() const;
+  void reset();
+
+private:
+  static constexpr int kRecentSamples = 32;
+
+  std::array<LatencyHistogram, static_cast<int>(LatencyStage::Count)>
+      histograms;
+  std::array<uint64_t, kRecentSamples> recent{};
+  int recent_next = 0;
+  int recent_count = 0;
+};
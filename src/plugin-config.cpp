@@ -1,4 +1,5 @@
 #include "plugin-config.hpp"
+#include "plugin-log.hpp"
 #include <QJsonArray>
 #include <obs-module.h>
 #include <QDir>
@@ -6,7 +7,8 @@
 #include <filesystem>
 
 void PluginConfig::save_to_file(const QString &filepath) {
-  blog(LOG_INFO, "[Auto Hide] Tentando salvar config em: %s", filepath.toUtf8().constData());
+  PluginLog::write(LogLevel::Debug, "[Auto Hide] Tentando salvar config em: %s",
+                   filepath.toUtf8().constData());
 
   // Usar std::filesystem para evitar problemas de ABI com QDir::mkpath no macOS
   std::filesystem::path path;
@@ -39,7 +41,9 @@ void PluginConfig::save_to_file(const QString &filepath) {
   QJsonDocument doc(root);
   QByteArray jsonBytes = doc.toJson();
 
-  blog(LOG_INFO, "[Auto Hide] Salvando JSON: %s", jsonBytes.constData());
+  // JSON completo só no nível debug (ring buffer)
+  PluginLog::write(LogLevel::Debug, "[Auto Hide] Salvando JSON: %s",
+                   jsonBytes.constData());
 
   qint64 bytes = file.write(jsonBytes);
   file.close();
@@ -48,7 +52,8 @@ void PluginConfig::save_to_file(const QString &filepath) {
 }
 
 void PluginConfig::load_from_file(const QString &filepath) {
-  blog(LOG_INFO, "[Auto Hide] Tentando carregar config de: %s", filepath.toUtf8().constData());
+  PluginLog::write(LogLevel::Debug, "[Auto Hide] Tentando carregar config de: %s",
+                   filepath.toUtf8().constData());
 
   QFile file(filepath);
   if (!file.open(QIODevice::ReadOnly)) {
@@ -59,7 +64,8 @@ void PluginConfig::load_from_file(const QString &filepath) {
   QByteArray data = file.readAll();
   file.close();
 
-  blog(LOG_INFO, "[Auto Hide] JSON Lido: %s", data.constData());
+  PluginLog::write(LogLevel::Debug, "[Auto Hide] JSON Lido: %s",
+                   data.constData());
 
   QJsonDocument doc = QJsonDocument::fromJson(data);
   if (!doc.isNull() && doc.isObject()) {
@@ -78,13 +84,30 @@ QJsonObject PluginConfig::to_json() const {
   QJsonObject connection;
   connection["client_type"] = client_type;
   connection["url"] = holyrics_url;
+  connection["backup_urls"] = QJsonArray::fromStringList(backup_urls);
   connection["polling_interval"] = polling_interval_ms;
+  connection["push_mode"] = push_mode;
+  connection["stream_path"] = stream_path;
+  connection["next_item_path"] = next_item_path;
+  connection["transport"] = transport;
+  QJsonArray extra_array;
+  for (const ClientEndpoint &endpoint : extra_clients) {
+    QJsonObject extra;
+    extra["client_type"] = endpoint.type;
+    extra["url"] = endpoint.url;
+    extra["backup_urls"] = QJsonArray::fromStringList(endpoint.backup_urls);
+    extra_array.append(extra);
+  }
+  connection["extra_clients"] = extra_array;
+  connection["combine"] = client_combine;
   root["connection"] = connection;
 
   // Plugin
   QJsonObject plugin;
   plugin["auto_activate"] = auto_activate;
   plugin["disable_in_music"] = disable_in_music;
+  plugin["log_level"] = log_level;
+  plugin["trace_capture"] = trace_capture;
   root["plugin"] = plugin;
 
   // Scenes
@@ -100,11 +123,22 @@ QJsonObject PluginConfig::to_json() const {
   // Behavior
   QJsonObject behavior;
   behavior["restore_previous_state"] = restore_previous_state;
-  behavior["action_delay_ms"] = action_delay_ms;
+  behavior["hide_confirm_ms"] = hide_confirm_ms;
+  behavior["show_confirm_ms"] = show_confirm_ms;
+  behavior["min_dwell_ms"] = min_dwell_ms;
   behavior["show_notifications"] = show_notifications;
   behavior["auto_transition"] = auto_transition;
+  behavior["frame_aligned"] = frame_aligned;
+  behavior["all_scenes"] = all_scenes;
   root["behavior"] = behavior;
 
+  // Content rules
+  QJsonObject rules;
+  for (auto it = content_rules.constBegin(); it != content_rules.constEnd(); ++it) {
+    rules[it.key()] = it.value();
+  }
+  root["content_rules"] = rules;
+
   return root;
 }
 
@@ -113,8 +147,32 @@ void PluginConfig::from_json(const QJsonObject &json) {
     QJsonObject connection = json["connection"].toObject();
     client_type = connection["client_type"].toString(client_type);
     holyrics_url = connection["url"].toString(holyrics_url);
+    backup_urls.clear();
+    for (const auto &val : connection["backup_urls"].toArray()) {
+      if (!val.toString().isEmpty())
+        backup_urls.append(val.toString());
+    }
     polling_interval_ms =
         connection["polling_interval"].toInt(polling_interval_ms);
+    push_mode = connection["push_mode"].toBool(push_mode);
+    stream_path = connection["stream_path"].toString(stream_path);
+    next_item_path = connection["next_item_path"].toString(next_item_path);
+    transport = connection["transport"].toString(transport);
+    client_combine = connection["combine"].toString(client_combine);
+
+    extra_clients.clear();
+    for (const auto &val : connection["extra_clients"].toArray()) {
+      QJsonObject extra = val.toObject();
+      ClientEndpoint endpoint;
+      endpoint.type = extra["client_type"].toString("Holyrics");
+      endpoint.url = extra["url"].toString();
+      for (const auto &backup : extra["backup_urls"].toArray()) {
+        if (!backup.toString().isEmpty())
+          endpoint.backup_urls.append(backup.toString());
+      }
+      if (!endpoint.url.isEmpty())
+        extra_clients.append(endpoint);
+    }
   } else if (json.contains("holyrics")) {
     // Backwards compatibility
     QJsonObject holyrics = json["holyrics"].toObject();
@@ -128,6 +186,8 @@ void PluginConfig::from_json(const QJsonObject &json) {
     QJsonObject plugin = json["plugin"].toObject();
     auto_activate = plugin["auto_activate"].toBool(auto_activate);
     disable_in_music = plugin["disable_in_music"].toBool(disable_in_music);
+    log_level = plugin["log_level"].toString(log_level);
+    trace_capture = plugin["trace_capture"].toBool(trace_capture);
   }
 
   if (json.contains("scenes")) {
@@ -145,9 +205,40 @@ void PluginConfig::from_json(const QJsonObject &json) {
     QJsonObject behavior = json["behavior"].toObject();
     restore_previous_state =
         behavior["restore_previous_state"].toBool(restore_previous_state);
-    action_delay_ms = behavior["action_delay_ms"].toInt(action_delay_ms);
+    // Migração: o delay único antigo vira os dois tempos de confirmação
+    if (behavior.contains("action_delay_ms") &&
+        !behavior.contains("hide_confirm_ms")) {
+      hide_confirm_ms = behavior["action_delay_ms"].toInt(hide_confirm_ms);
+      show_confirm_ms = hide_confirm_ms;
+    }
+    hide_confirm_ms = behavior["hide_confirm_ms"].toInt(hide_confirm_ms);
+    show_confirm_ms = behavior["show_confirm_ms"].toInt(show_confirm_ms);
+    min_dwell_ms = behavior["min_dwell_ms"].toInt(min_dwell_ms);
     show_notifications =
         behavior["show_notifications"].toBool(show_notifications);
     auto_transition = behavior["auto_transition"].toBool(auto_transition);
+    frame_aligned = behavior["frame_aligned"].toBool(frame_aligned);
+    all_scenes = behavior["all_scenes"].toBool(all_scenes);
+  }
+
+  if (json.contains("content_rules")) {
+    // Parte das regras padrão: tipos omitidos mantêm o perfil padrão
+    content_rules = default_content_rules();
+    QJsonObject rules = json["content_rules"].toObject();
+    for (auto it = rules.constBegin(); it != rules.constEnd(); ++it) {
+      content_rules[it.key().toUpper()] = it.value().toString();
+    }
+  }
+}
+
+bool PluginConfig::holyrics_push_inactive() const {
+  if (!push_mode || !stream_path.isEmpty())
+    return false;
+  if (client_type != "ProPresent")
+    return true;
+  for (const ClientEndpoint &endpoint : extra_clients) {
+    if (endpoint.type != "ProPresent")
+      return true;
   }
+  return false;
 }
@@ -1,18 +1,36 @@
 #pragma once
 
+#include "content-rules.hpp"
 #include <QFile>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QList>
+#include <QMap>
 #include <QString>
 #include <QStringList>
 
+// Cliente adicional que roda junto com o principal
+struct ClientEndpoint {
+  QString type; // "Holyrics" ou "ProPresent"
+  QString url;
+  QStringList backup_urls; // Usadas em ordem quando url não responde
+};
+
 struct PluginConfig {
   // Client selection
   QString client_type = "Holyrics"; // Padrão: Holyrics
 
   // Connection
   QString holyrics_url = "http://localhost:9000";
+  QStringList backup_urls; // Reservas do cliente principal, em ordem
   int polling_interval_ms = 1000;
+  bool push_mode = false; // Usar stream de status em vez de polling
+  QString stream_path;    // Holyrics: caminho do stream (SSE/JSON chunked)
+  QString next_item_path; // Holyrics: playlist / próximo item (pré-armar)
+  QString transport = "Qt"; // "Qt" ou "KeepAlive" (conexão TCP persistente)
+  // Vários clientes ao mesmo tempo (o principal é client_type/holyrics_url)
+  QList<ClientEndpoint> extra_clients;
+  QString client_combine = "any"; // "any", "all" ou "priority"
 
   // Controle
   QString monitored_scene;
@@ -20,15 +38,31 @@ struct PluginConfig {
 
   // Comportamento
   bool restore_previous_state = true;
-  int action_delay_ms = 150;
+  // Filtro do versículo (substitui o antigo action_delay_ms)
+  int hide_confirm_ms = 150; // Versículo estável por X ms antes de esconder
+  int show_confirm_ms = 400; // Sem versículo por X ms antes de mostrar
+  int min_dwell_ms = 1000;   // Tempo mínimo entre duas mudanças aplicadas
   bool show_notifications = true;
   bool auto_activate = false; // Padrão: DESLIGADO
   bool auto_transition = true; // Acionar transição automaticamente no modo estúdio
+  bool frame_aligned = false; // Aplicar no início do próximo tick de vídeo
+  bool all_scenes = false; // Aplicar em todas as cenas que contêm as fontes
   bool disable_in_music = false; // Padrão: DESLIGADO
+  // Tipo de conteúdo (BIBLE, MUSIC, ..., EMPTY, OTHER) → perfil de ação
+  // (show, hide, hide_if_text, keep, deactivate)
+  QMap<QString, QString> content_rules = default_content_rules();
+
+  // Diagnóstico
+  QString log_level = "info"; // "debug", "info", "warning" ou "error"
+  bool trace_capture = false; // Gravar o feed em <config>/traces/*.aht
 
   // Métodos
   void save_to_file(const QString &filepath);
   void load_from_file(const QString &filepath);
   QJsonObject to_json() const;
   void from_json(const QJsonObject &json);
+
+  // Push ligado, mas algum cliente Holyrics não tem caminho de stream
+  // (esse cliente continua só no polling)
+  bool holyrics_push_inactive() const;
 };
@@ -0,0 +1,167 @@
+#include "plugin-log.hpp"
+#include <obs-module.h>
+#include <util/platform.h>
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+// Janela do rate limit e quantas mensagens iguais passam em cada uma
+static constexpr uint64_t kRateWindowNs = 10ULL * 1000000000ULL;
+static constexpr uint32_t kRateBurst = 5;
+// Ring buffer de debug: linhas de tamanho fixo, sem alocação por mensagem
+static constexpr size_t kDebugLines = 256;
+static constexpr size_t kDebugLineBytes = 256;
+// Linha formatada (mensagens maiores são truncadas)
+static constexpr size_t kFormatBytes = 4096;
+
+struct RateState {
+  uint64_t window_start_ns = 0;
+  uint32_t count = 0;
+  uint64_t suppressed = 0;
+  int obs_level = LOG_INFO;
+};
+
+struct DebugLine {
+  uint64_t timestamp_ns = 0;
+  char text[kDebugLineBytes] = {};
+};
+
+static std::atomic<LogLevel> current_level{LogLevel::Info};
+static std::mutex log_mutex;
+// Chave = ponteiro do format: cada ponto de chamada é um "tipo" de mensagem
+static std::unordered_map<const char *, RateState> rate_states;
+static std::array<DebugLine, kDebugLines> debug_ring;
+static size_t ring_next = 0;
+static size_t ring_count = 0;
+
+static int obs_level_for(LogLevel level) {
+  switch (level) {
+  case LogLevel::Error:
+    return LOG_ERROR;
+  case LogLevel::Warning:
+    return LOG_WARNING;
+  default:
+    // LOG_DEBUG é descartado pelo OBS em builds release
+    return LOG_INFO;
+  }
+}
+
+static void emit_suppressed(const char *format, uint64_t suppressed,
+                            int obs_level) {
+  blog(obs_level, "[Auto Hide] %llu mensagens semelhantes suprimidas: \"%.80s\"",
+       (unsigned long long)suppressed, format);
+}
+
+void PluginLog::set_level(LogLevel level) { current_level = level; }
+
+LogLevel PluginLog::level() { return current_level; }
+
+LogLevel PluginLog::level_from_string(const QString &name) {
+  if (name.compare("debug", Qt::CaseInsensitive) == 0)
+    return LogLevel::Debug;
+  if (name.compare("warning", Qt::CaseInsensitive) == 0)
+    return LogLevel::Warning;
+  if (name.compare("error", Qt::CaseInsensitive) == 0)
+    return LogLevel::Error;
+  return LogLevel::Info;
+}
+
+QString PluginLog::level_to_string(LogLevel level) {
+  switch (level) {
+  case LogLevel::Debug:
+    return "debug";
+  case LogLevel::Warning:
+    return "warning";
+  case LogLevel::Error:
+    return "error";
+  default:
+    return "info";
+  }
+}
+
+void PluginLog::write(LogLevel level, const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+  write_va(level, format, args);
+  va_end(args);
+}
+
+void PluginLog::write_va(LogLevel level, const char *format, va_list args) {
+  const bool to_obs = level >= current_level.load();
+  const bool to_ring = level == LogLevel::Debug;
+  if (!to_obs && !to_ring)
+    return;
+
+  char line[kFormatBytes];
+  vsnprintf(line, sizeof(line), format, args);
+
+  const uint64_t now = os_gettime_ns();
+  const int obs_level = obs_level_for(level);
+  uint64_t suppressed = 0;
+
+  {
+    std::lock_guard<std::mutex> lock(log_mutex);
+
+    if (to_ring) {
+      DebugLine &slot = debug_ring[ring_next];
+      slot.timestamp_ns = now;
+      std::strncpy(slot.text, line, kDebugLineBytes - 1);
+      slot.text[kDebugLineBytes - 1] = '\0';
+      ring_next = (ring_next + 1) % kDebugLines;
+      if (ring_count < kDebugLines)
+        ring_count++;
+    }
+
+    if (!to_obs)
+      return;
+
+    RateState &state = rate_states[format];
+    if (now - state.window_start_ns >= kRateWindowNs) {
+      // Nova janela: o resumo da anterior sai junto com esta mensagem
+      suppressed = state.suppressed;
+      state.window_start_ns = now;
+      state.count = 0;
+      state.suppressed = 0;
+    }
+
+    if (state.count >= kRateBurst) {
+      state.suppressed++;
+      state.obs_level = obs_level;
+      return;
+    }
+    state.count++;
+  }
+
+  if (suppressed > 0)
+    emit_suppressed(format, suppressed, obs_level);
+  blog(obs_level, "%s", line);
+}
+
+int PluginLog::dump_recent_debug() {
+  std::lock_guard<std::mutex> lock(log_mutex);
+  const uint64_t now = os_gettime_ns();
+
+  blog(LOG_INFO, "[Auto Hide] ---- Últimas %d linhas de debug ----",
+       (int)ring_count);
+
+  size_t first = (ring_next + kDebugLines - ring_count) % kDebugLines;
+  for (size_t i = 0; i < ring_count; i++) {
+    const DebugLine &slot = debug_ring[(first + i) % kDebugLines];
+    double age_s = (double)(now - slot.timestamp_ns) / 1000000000.0;
+    blog(LOG_INFO, "[-%.3f s] %s", age_s, slot.text);
+  }
+
+  // Resumos que ainda esperavam a próxima mensagem do mesmo tipo
+  for (auto &[format, state] : rate_states) {
+    if (state.suppressed > 0) {
+      emit_suppressed(format, state.suppressed, state.obs_level);
+      state.suppressed = 0;
+    }
+  }
+
+  blog(LOG_INFO, "[Auto Hide] ---- Fim do log de debug ----");
+  return (int)ring_count;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <QString>
+#include <cstdarg>
+#include <util/c99defs.h>
+
+// Níveis do log do plugin (do mais verboso ao mais grave)
+enum class LogLevel { Debug, Info, Warning, Error };
+
+// Log central do plugin, seguro entre threads (os clientes logam da thread
+// de rede).
+//  - Mensagens abaixo do nível configurado não vão para o log do OBS.
+//  - Mensagens repetidas (mesmo ponto de chamada = mesmo format) passam
+//    no máximo algumas vezes por janela; o resto vira um resumo
+//    "N mensagens semelhantes suprimidas".
+//  - Linhas de debug vão sempre para um ring buffer em memória, que pode ser
+//    despejado no log do OBS sob demanda.
+class PluginLog {
+public:
+  static void set_level(LogLevel level);
+  static LogLevel level();
+
+  // "debug", "info", "warning", "error" (desconhecido = info)
+  static LogLevel level_from_string(const QString &name);
+  static QString level_to_string(LogLevel level);
+
+  static void write(LogLevel level, const char *format, ...)
+      PRINTFATTR(2, 3);
+  static void write_va(LogLevel level, const char *format, va_list args);
+
+  // Escreve no log do OBS as linhas de debug recentes (mais antigas
+  // primeiro) e os resumos de supressão pendentes. Retorna quantas linhas.
+  static int dump_recent_debug();
+};
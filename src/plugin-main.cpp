@@ -1,11 +1,17 @@
 #include "auto-hide-dock.hpp"
+#include "client-group.hpp"
 #include "holyrics-client.hpp"
+#include "latency-stats.hpp"
 #include "propresent-client.hpp"
 #include "plugin-config.hpp"
+#include "plugin-log.hpp"
+#include "prearm-gate.hpp"
 #include "scene-controller.hpp"
+#include "verse-filter.hpp"
 #include <obs-module.h>
 #include <obs-frontend-api.h>
 #include <util/bmem.h>
+#include <QThread>
 
 OBS_DECLARE_MODULE()
 // OBS_MODULE_USE_DEFAULT_LOCALE("auto-hide-scenes", "en-US")
@@ -13,43 +19,239 @@ OBS_DECLARE_MODULE()
 class AutoHidePlugin {
 private:
   PluginConfig config;
+  // Sempre um ClientGroup (um ou mais clientes); o dock só vê a interface
   IPresentationClient *active_client = nullptr;
+  ClientGroup *client_group = nullptr;
+  // Tipos/URLs com que o grupo atual foi montado
+  QString active_client_signature;
   SceneController *scene_controller;
   AutoHideDockWidget *dock_widget;
 
-  void setup_client() {
-    // Deleta o anterior se existir
-    if (active_client) {
-        active_client->disconnect();
-        delete active_client;
-        active_client = nullptr;
+  // Rede e detecção rodam fora da thread da UI do OBS
+  QThread network_thread;
+  // Incrementado a cada cliente novo: descarta eventos de clientes antigos
+  quint64 client_generation = 0;
+
+  // Histogramas de latência (thread da UI)
+  LatencyStats latency_stats;
+
+  // Confirmação/histerese entre o cliente e a cena (thread da UI)
+  VerseStateFilter verse_filter;
+  // Preparação do hide pelo próximo item (desarma só com o filtro assentado)
+  PrearmGate prearm_gate{verse_filter};
+
+  PipelineTransport pipeline_transport() const {
+    return config.transport == "KeepAlive" ? PipelineTransport::KeepAlive
+                                           : PipelineTransport::Qt;
+  }
+
+  // Diretório dos traces do feed (vazio = gravação desligada)
+  QString trace_capture_directory() const {
+    if (!config.trace_capture)
+      return QString();
+
+    QString directory;
+    char *path_ptr = obs_module_config_path("traces");
+    if (path_ptr) {
+      directory = QString::fromUtf8(path_ptr);
+      bfree(path_ptr);
     }
+    return directory;
+  }
+
+  static QObject *client_object(IPresentationClient *client) {
+    return dynamic_cast<QObject *>(client);
+  }
+
+  // Executa na thread do cliente (na ordem das chamadas)
+  template <typename F> void run_on_client_thread(F &&fn) {
+    if (!active_client)
+      return;
+    QMetaObject::invokeMethod(client_object(active_client),
+                              std::forward<F>(fn), Qt::QueuedConnection);
+  }
 
-    // Instancia o novo baseado na config
-    if (config.client_type == "ProPresent") {
-        active_client = new ProPresentClient();
-        blog(LOG_INFO, "[Auto Hide] Inicializando ProPresent Client");
+  void destroy_client() {
+    if (!active_client)
+      return;
+
+    IPresentationClient *client = active_client;
+    active_client = nullptr;
+    client_group = nullptr;
+    client_generation++;
+    // Ações pedidas pelo cliente antigo não devem mais ser aplicadas
+    scene_controller->cancel_pending_actions();
+    prearm_gate.reset();
+    verse_filter.reset();
+
+    // Destrói na própria thread e espera terminar
+    QMetaObject::invokeMethod(
+        client_object(client), [client]() { delete client; },
+        Qt::BlockingQueuedConnection);
+  }
+
+  // Muda quando é preciso recriar os clientes
+  QString client_signature() const {
+    QString signature = config.client_type + " " + config.backup_urls.join(" ");
+    for (const ClientEndpoint &endpoint : config.extra_clients) {
+      signature += "|" + endpoint.type + " " + endpoint.url + " " +
+                   endpoint.backup_urls.join(" ");
+    }
+    return signature;
+  }
+
+  static IPresentationClient *create_client(const QString &type,
+                                            const QStringList &backup_urls) {
+    IPresentationClient *client;
+    if (type == "ProPresent") {
+      blog(LOG_INFO, "[Auto Hide] Inicializando ProPresent Client");
+      client = new ProPresentClient();
     } else {
-        active_client = new HolyricsClient();
-        blog(LOG_INFO, "[Auto Hide] Inicializando Holyrics Client");
+      blog(LOG_INFO, "[Auto Hide] Inicializando Holyrics Client");
+      client = new HolyricsClient();
     }
+    client->set_backup_urls(backup_urls);
+    return client;
+  }
 
-    // Configurar callbacks
-    active_client->on_verse_changed = [this](bool visible) {
-      on_verse_state_changed(visible);
+  void setup_client() {
+    // Deleta o anterior se existir
+    destroy_client();
+
+    // O principal usa a URL do connect(); os adicionais, a própria
+    ClientGroup *group = new ClientGroup();
+    group->add_client(create_client(config.client_type, config.backup_urls));
+    for (const ClientEndpoint &endpoint : config.extra_clients) {
+      group->add_client(create_client(endpoint.type, endpoint.backup_urls),
+                        endpoint.url);
+    }
+    group->set_combine(client_combine_from_string(config.client_combine));
+
+    active_client = group;
+    client_group = group;
+    active_client_signature = client_signature();
+    QObject *client_obj = group;
+
+    // Antes de qualquer uso: timers e sockets passam a viver na thread de rede
+    client_obj->moveToThread(&network_thread);
+
+    // Configurar callbacks. Chegam na thread de rede; só as mudanças de
+    // estado são repassadas para a thread da UI, onde vive o SceneController.
+    const quint64 generation = client_generation;
+
+    active_client->on_verse_changed = [this, generation](
+                                           bool visible,
+                                           const TransitionTrace &trace) {
+      QMetaObject::invokeMethod(
+          dock_widget,
+          [this, generation, visible, trace]() {
+            if (generation != client_generation)
+              return;
+            verse_filter.submit(visible, trace);
+          },
+          Qt::QueuedConnection);
     };
 
-    active_client->on_deactivation_requested = [this]() {
-        if (dock_widget) {
-            scene_controller->hide_sources(config.sources_to_hide);
+    active_client->on_deactivation_requested = [this, generation]() {
+      QMetaObject::invokeMethod(
+          dock_widget,
+          [this, generation]() {
+            if (generation != client_generation || !dock_widget->is_active())
+              return;
+            // Desativa primeiro: o hide entra depois do cancelamento
             dock_widget->set_active(false, false);
+            scene_controller->hide_sources(config.sources_to_hide);
             blog(LOG_INFO, "[Auto Hide] Desativação automática (MUSIC): Fontes ocultadas e plugin parado.");
-        }
+          },
+          Qt::QueuedConnection);
+    };
+
+    active_client->on_connection_state_changed = [this, generation](
+                                                     ConnectionState state) {
+      QMetaObject::invokeMethod(
+          dock_widget,
+          [this, generation, state]() {
+            if (generation != client_generation)
+              return;
+            dock_widget->update_connection_status(state);
+          },
+          Qt::QueuedConnection);
+    };
+
+    // Primeira resposta: o rótulo sai de "Conectando..."
+    active_client->on_reachability_changed = [this, generation](bool reachable) {
+      QMetaObject::invokeMethod(
+          dock_widget,
+          [this, generation, reachable]() {
+            if (generation != client_generation)
+              return;
+            dock_widget->update_reachability(reachable);
+          },
+          Qt::QueuedConnection);
+    };
+
+    // Próximo item é versículo: deixa o hide pronto antes da troca
+    active_client->on_upcoming_changed = [this, generation](bool upcoming) {
+      QMetaObject::invokeMethod(
+          dock_widget,
+          [this, generation, upcoming]() {
+            if (generation != client_generation)
+              return;
+            prearm_gate.set_upcoming(upcoming);
+          },
+          Qt::QueuedConnection);
     };
   }
 
+  void apply_client_settings() {
+    if (!client_group)
+      return;
+
+    const int polling_interval_ms = config.polling_interval_ms;
+    const bool disable_in_music = config.disable_in_music;
+    const bool push_mode = config.push_mode;
+    const QString stream_path = config.stream_path;
+    const QString next_item_path = config.next_item_path;
+    const PipelineTransport transport = pipeline_transport();
+    const QString trace_directory = trace_capture_directory();
+    const ClientCombine combine =
+        client_combine_from_string(config.client_combine);
+    // Compilada uma vez aqui; os clientes só consultam a tabela
+    const ContentRuleTable content_rules =
+        ContentRuleTable::compile(config.content_rules, disable_in_music);
+    ClientGroup *group = client_group;
+
+    run_on_client_thread([=]() {
+      group->set_combine(combine);
+      group->set_polling_interval(polling_interval_ms);
+
+      for (int i = 0; i < group->size(); i++) {
+        // Holyrics suporta as configurações estendidas (stream_path)
+        if (auto *hc = dynamic_cast<HolyricsClient *>(group->client(i))) {
+          hc->set_polling_interval(polling_interval_ms);
+          hc->set_content_rules(content_rules);
+          hc->set_stream_path(stream_path);
+          hc->set_next_item_path(next_item_path);
+          hc->set_push_mode(push_mode);
+          hc->set_transport(transport);
+          hc->set_trace_capture(trace_directory);
+        } else if (auto *ppc =
+                       dynamic_cast<ProPresentClient *>(group->client(i))) {
+          ppc->set_polling_interval(polling_interval_ms);
+          ppc->set_disable_in_music(disable_in_music);
+          ppc->set_push_mode(push_mode);
+          ppc->set_transport(transport);
+          ppc->set_trace_capture(trace_directory);
+        }
+      }
+    });
+  }
+
 public:
   AutoHidePlugin() {
+    network_thread.setObjectName("auto-hide-network");
+    network_thread.start();
+
     scene_controller = new SceneController();
     
     // O DockWidget precisa do PONTEIRO para onde armazenamos o cliente ativo, 
@@ -60,27 +262,69 @@ public:
     dock_widget->on_settings_changed = [this]() {
         this->apply_settings_change();
     };
+
+    // Só mudanças confirmadas pelo filtro chegam na cena
+    verse_filter.on_state_confirmed = [this](bool visible,
+                                             const TransitionTrace &trace) {
+        on_verse_state_changed(visible, trace);
+    };
+    verse_filter.on_stats_changed = [this](const VerseFilterStats &stats) {
+        dock_widget->update_filter_stats(stats);
+        prearm_gate.filter_changed();
+    };
+
+    prearm_gate.on_arm = [this]() {
+        if (dock_widget->is_active())
+            scene_controller->prearm_hide(config.sources_to_hide);
+    };
+    prearm_gate.on_disarm = [this]() { scene_controller->disarm_prearm(); };
+
+    // Ativar/desativar recomeça do estado "sem versículo", como o cliente.
+    // Desativado, nenhuma ação pedida antes (nem o preview preparado) vale.
+    dock_widget->on_activation_changed = [this](bool active) {
+        prearm_gate.reset();
+        if (active)
+            scene_controller->disarm_prearm();
+        else
+            scene_controller->cancel_pending_actions();
+        verse_filter.reset();
+    };
+
+    // Latência slide -> fonte: cada transição aplicada alimenta os histogramas
+    scene_controller->on_transition_applied = [this](const TransitionTrace &trace) {
+        latency_stats.record(trace);
+        // Alinhado ao quadro: mostra também em quadros de vídeo
+        dock_widget->update_latency(latency_stats,
+                                    scene_controller->is_frame_aligned()
+                                        ? obs_get_frame_interval_ns()
+                                        : 0);
+    };
   }
 
   ~AutoHidePlugin() {
-    if (active_client) delete active_client;
+    // O dock pode já ter sido destruído: nada de restaurar a cena aqui
+    verse_filter.on_state_confirmed = nullptr;
+    destroy_client();
+    network_thread.quit();
+    network_thread.wait();
     delete scene_controller;
     // dock_widget é deletado pelo OBS ao fechar ou remover dock
   }
 
-  void on_verse_state_changed(bool verse_visible) {
+  void on_verse_state_changed(bool verse_visible,
+                              const TransitionTrace &trace) {
     blog(LOG_INFO, "[Auto Hide] Versículo: %s",
          verse_visible ? "APARECEU" : "SUMIU");
 
     if (verse_visible) {
       // Esconder fontes configuradas
-      scene_controller->hide_sources(config.sources_to_hide);
+      scene_controller->hide_sources(config.sources_to_hide, trace);
     } else {
       // Restaurar estado anterior
       if (config.restore_previous_state) {
-        scene_controller->restore_previous_state();
+        scene_controller->restore_previous_state(trace);
       } else {
-        scene_controller->show_all_sources(config.sources_to_hide);
+        scene_controller->show_all_sources(config.sources_to_hide, trace);
       }
     }
 
@@ -90,7 +334,6 @@ public:
 
   void load_config() {
     char *path_ptr = obs_module_config_path("config.json");
-    QString old_client_type = config.client_type;
     
     if (path_ptr) {
         QString path = QString(path_ptr);
@@ -101,26 +344,19 @@ public:
         blog(LOG_WARNING, "[Auto Hide] obs_module_config_path retornou NULL");
     }
 
-    // Se mudou o client_type, ou se é a primeira vez (active_client nulo), configura o cliente
-    if (!active_client || old_client_type != config.client_type) {
+    // Se mudaram os clientes, ou se é a primeira vez (active_client nulo), configura o grupo
+    if (!active_client || active_client_signature != client_signature()) {
         setup_client();
     }
 
-    // Se é Holyrics, ele suporta as configurações estendidas (podemos testar com dynamic_cast pra ser seguros)
-    HolyricsClient* hc = dynamic_cast<HolyricsClient*>(active_client);
-    if (hc) {
-        hc->set_polling_interval(config.polling_interval_ms);
-        hc->set_disable_in_music(config.disable_in_music);
-    } else {
-        ProPresentClient* ppc = dynamic_cast<ProPresentClient*>(active_client);
-        if (ppc) {
-             ppc->set_polling_interval(config.polling_interval_ms);
-             ppc->set_disable_in_music(config.disable_in_music);
-        }
-    }
+    PluginLog::set_level(PluginLog::level_from_string(config.log_level));
+    apply_client_settings();
 
-    scene_controller->set_action_delay(config.action_delay_ms);
+    verse_filter.set_timing(config.hide_confirm_ms, config.show_confirm_ms,
+                            config.min_dwell_ms);
     scene_controller->set_auto_transition(config.auto_transition);
+    scene_controller->set_frame_aligned(config.frame_aligned);
+    scene_controller->set_all_scenes(config.all_scenes);
 
     // Se ativado automaticamente
     if (config.auto_activate) {
@@ -129,37 +365,27 @@ public:
   }
 
   void apply_settings_change() {
-    QString actual_client_type = "Holyrics";
-    if (dynamic_cast<ProPresentClient*>(active_client)) {
-        actual_client_type = "ProPresent";
-    }
+    bool clients_changed = (active_client_signature != client_signature());
 
-    bool type_changed = (actual_client_type != config.client_type);
-    
-    // Always recreate if type changed or client is null
-    if (!active_client || type_changed) {
+    // Always recreate if the client list changed or client is null
+    if (!active_client || clients_changed) {
         setup_client();
     }
 
     // Apply specific configs
-    HolyricsClient* hc = dynamic_cast<HolyricsClient*>(active_client);
-    if (hc) {
-        hc->set_polling_interval(config.polling_interval_ms);
-        hc->set_disable_in_music(config.disable_in_music);
-    } else {
-        ProPresentClient* ppc = dynamic_cast<ProPresentClient*>(active_client);
-        if (ppc) {
-             ppc->set_polling_interval(config.polling_interval_ms);
-             ppc->set_disable_in_music(config.disable_in_music);
-        }
-    }
+    PluginLog::set_level(PluginLog::level_from_string(config.log_level));
+    apply_client_settings();
 
-    scene_controller->set_action_delay(config.action_delay_ms);
+    verse_filter.set_timing(config.hide_confirm_ms, config.show_confirm_ms,
+                            config.min_dwell_ms);
     scene_controller->set_auto_transition(config.auto_transition);
+    scene_controller->set_frame_aligned(config.frame_aligned);
+    scene_controller->set_all_scenes(config.all_scenes);
 
     // If it was already active, we must reconnect the new client with the new URL
     if (dock_widget->is_active() && active_client) {
         active_client->disconnect(); // safe
+        dock_widget->reset_connection_status();
         active_client->connect(config.holyrics_url);
     }
     
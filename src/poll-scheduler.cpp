@@ -0,0 +1,88 @@
+#include "poll-scheduler.hpp"
+#include "request-pipeline.hpp"
+#include <algorithm>
+
+PollScheduler::PollScheduler(QObject *parent) : QObject(parent), timer(this) {
+  timer.setSingleShot(true);
+  timer.setTimerType(Qt::PreciseTimer);
+  QObject::connect(&timer, &QTimer::timeout, this, &PollScheduler::fire);
+  clock.start();
+}
+
+void PollScheduler::set_min_spacing(int ms) {
+  min_spacing_ms = qMax(0, ms);
+  arm();
+}
+
+void PollScheduler::schedule(RequestPipeline *pipeline, int delay_ms,
+                             PollPriority priority) {
+  const qint64 due_ms = clock.elapsed() + qMax(0, delay_ms);
+  auto it = std::find_if(queued.begin(), queued.end(), [pipeline](const QueuedPoll &s) {
+    return s.pipeline == pipeline;
+  });
+  if (it != queued.end()) {
+    it->due_ms = due_ms;
+    it->priority = priority;
+  } else {
+    queued.push_back({pipeline, due_ms, priority});
+  }
+  arm();
+}
+
+void PollScheduler::cancel(RequestPipeline *pipeline) {
+  queued.erase(std::remove_if(queued.begin(), queued.end(),
+                             [pipeline](const QueuedPoll &s) {
+                               return s.pipeline == pipeline;
+                             }),
+              queued.end());
+  arm();
+}
+
+qint64 PollScheduler::earliest_allowed(qint64 due_ms) const {
+  if (last_fire_ms < 0)
+    return due_ms;
+  return qMax(due_ms, last_fire_ms + min_spacing_ms);
+}
+
+qint64 PollScheduler::effective_due(const QueuedPoll &poll) const {
+  return poll.priority == PollPriority::Background
+             ? poll.due_ms + min_spacing_ms
+             : poll.due_ms;
+}
+
+std::vector<PollScheduler::QueuedPoll>::iterator PollScheduler::next_poll() {
+  return std::min_element(queued.begin(), queued.end(),
+                          [this](const QueuedPoll &a, const QueuedPoll &b) {
+                            return effective_due(a) < effective_due(b);
+                          });
+}
+
+void PollScheduler::arm() {
+  if (queued.empty()) {
+    timer.stop();
+    return;
+  }
+
+  const auto next = next_poll();
+  const qint64 wait_ms = earliest_allowed(effective_due(*next)) - clock.elapsed();
+  timer.start(static_cast<int>(qMax<qint64>(0, wait_ms)));
+}
+
+void PollScheduler::fire() {
+  if (queued.empty())
+    return;
+
+  const qint64 now = clock.elapsed();
+  const auto next = next_poll();
+  if (earliest_allowed(effective_due(*next)) > now) {
+    arm();
+    return;
+  }
+
+  RequestPipeline *pipeline = next->pipeline;
+  queued.erase(next);
+  last_fire_ms = now;
+  // Pode reagendar (resposta imediata de erro) ou cancelar: arma depois
+  pipeline->run_scheduled_poll();
+  arm();
+}
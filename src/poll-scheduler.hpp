@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+#include <vector>
+
+class RequestPipeline;
+
+enum class PollPriority {
+  Normal,
+  // Consultas auxiliares (ex: próximo item): na disputa por um horário,
+  // saem um espaçamento depois das normais
+  Background
+};
+
+// Agendador único para os pipelines de vários clientes: um timer só, e
+// duas consultas quaisquer ficam separadas por pelo menos min_spacing_ms.
+// Com N clientes a carga total fica limitada e as consultas não saem em
+// rajada no mesmo instante.
+//
+// Vive na mesma thread dos pipelines.
+class PollScheduler : public QObject {
+  Q_OBJECT
+
+public:
+  explicit PollScheduler(QObject *parent = nullptr);
+
+  void set_min_spacing(int ms);
+
+  // Próxima consulta do pipeline daqui a delay_ms (substitui a anterior)
+  void schedule(RequestPipeline *pipeline, int delay_ms,
+                PollPriority priority = PollPriority::Normal);
+  void cancel(RequestPipeline *pipeline);
+
+private:
+  struct QueuedPoll {
+    RequestPipeline *pipeline;
+    qint64 due_ms;
+    PollPriority priority;
+  };
+
+  std::vector<QueuedPoll> queued;
+  QTimer timer;
+  QElapsedTimer clock;
+  int min_spacing_ms = 0;
+  qint64 last_fire_ms = -1;
+
+  qint64 earliest_allowed(qint64 due_ms) const;
+  // Momento usado na ordenação (Background cede um espaçamento)
+  qint64 effective_due(const QueuedPoll &poll) const;
+  std::vector<QueuedPoll>::iterator next_poll();
+  void arm();
+  void fire();
+};
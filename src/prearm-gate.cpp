@@ -0,0 +1,36 @@
+#include "prearm-gate.hpp"
+#include "plugin-log.hpp"
+
+PrearmGate::PrearmGate(const VerseStateFilter &filter) : filter(filter) {}
+
+void PrearmGate::set_upcoming(bool upcoming) {
+  if (upcoming) {
+    release_pending = false;
+    if (on_arm)
+      on_arm();
+    return;
+  }
+
+  if (filter.is_idle()) {
+    release();
+    return;
+  }
+
+  // Versículo pendente ou na tela: o hide normal vai usar a preparação
+  if (!release_pending) {
+    PluginLog::write(LogLevel::Debug,
+                     "[Auto Hide DEBUG] Preparação mantida até o filtro assentar");
+  }
+  release_pending = true;
+}
+
+void PrearmGate::filter_changed() {
+  if (release_pending && filter.is_idle())
+    release();
+}
+
+void PrearmGate::release() {
+  release_pending = false;
+  if (on_disarm)
+    on_disarm();
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "verse-filter.hpp"
+#include <functional>
+
+// Decide quando preparar e quando desfazer o hide pré-armado a partir do
+// "próximo item" do cliente. Quando o versículo previsto entra no ar, o
+// próximo item passa a ser o seguinte e o upcoming vira false antes de o
+// filtro confirmar o versículo: desfazer nessa hora piscaria o Preview e
+// perderia a preparação. Por isso o desarme espera o filtro assentar em
+// "sem versículo" (fim confirmado ou mudança descartada como piscada).
+//
+// Vive na thread da UI, junto com o VerseStateFilter.
+class PrearmGate {
+public:
+  explicit PrearmGate(const VerseStateFilter &filter);
+
+  void set_upcoming(bool upcoming);
+  // Chamar a cada mudança do filtro (on_stats_changed / on_state_confirmed)
+  void filter_changed();
+  // Plugin desativado / cliente recriado: esquece o desarme pendente
+  void reset() { release_pending = false; }
+
+  bool is_release_pending() const { return release_pending; }
+
+  std::function<void()> on_arm;
+  std::function<void()> on_disarm;
+
+private:
+  const VerseStateFilter &filter;
+  bool release_pending = false;
+
+  void release();
+};
@@ -1,9 +1,16 @@
 #pragma once
 
+#include "connection-breaker.hpp"
+#include "latency-stats.hpp"
 #include <QString>
+#include <QStringList>
 #include <functional>
 
-// Interface comum para diferentes softwares de apresentação
+class PollScheduler;
+
+// Interface comum para diferentes softwares de apresentação.
+// connect()/disconnect()/is_connected() podem ser chamados de qualquer
+// thread; os callbacks são chamados na thread onde o cliente vive.
 class IPresentationClient {
 public:
     virtual ~IPresentationClient() = default;
@@ -16,13 +23,33 @@ public:
     
     // Retorna se está monitorando
     virtual bool is_connected() = 0;
+
+    // Agendador de polling compartilhado (vários clientes ao mesmo tempo).
+    // Chamado antes de connect(), na thread do cliente.
+    virtual void set_poll_scheduler(PollScheduler *scheduler) { (void)scheduler; }
+
+    // URLs reserva, em ordem, usadas quando a do connect() não responde.
+    // Chamado antes de connect().
+    virtual void set_backup_urls(const QStringList &urls) { (void)urls; }
     
     // Callback quando estado do versículo muda
     // true = versículo visível
     // false = versículo não visível (música, logo, etc)
-    std::function<void(bool verse_visible)> on_verse_changed;
+    // trace: momentos da consulta/detecção (medição de latência)
+    std::function<void(bool verse_visible, const TransitionTrace &trace)>
+        on_verse_changed;
 
     // Callback para solicitar desativação total do plugin
     // (Ex: quando detecta tipo "MUSIC")
     std::function<void()> on_deactivation_requested;
+
+    // Callback quando o servidor passa a responder (true) ou falha (false)
+    std::function<void(bool reachable)> on_reachability_changed;
+
+    // Callback nas transições do estado da conexão (circuit breaker)
+    std::function<void(ConnectionState state)> on_connection_state_changed;
+
+    // Callback quando o próximo item passa a esconder as fontes (true) ou
+    // deixa de esconder (false). Só prepara: a troca vem em on_verse_changed.
+    std::function<void(bool upcoming_verse)> on_upcoming_changed;
 };
@@ -1,97 +1,352 @@
 #include "propresent-client.hpp"
+#include "json-scanner.hpp"
 #include <obs-module.h>
 #include <QNetworkRequest>
 #include <QNetworkReply>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonValue>
+#include <QDateTime>
+#include <QThread>
+#include <util/platform.h>
+#include <utility>
 
-ProPresentClient::ProPresentClient(QObject *parent) : QObject(parent) {
+// Tópicos assinados no stream de status do ProPresenter
+static const char *kStreamTopics =
+    "[\"presentation/active\",\"presentation/slide_index\"]";
+// Tempo até tentar reabrir o stream depois de uma queda
+static constexpr int kStreamRetryMs = 5000;
+
+ProPresentClient::ProPresentClient(QObject *parent)
+    : QObject(parent), stream_retry_timer(this) {
   network_manager = new QNetworkAccessManager(this);
+  status_stream = new StatusStream(network_manager, this);
+  pipeline = new RequestPipeline(network_manager, this);
+
+  // Uma requisição por vez; a próxima é agendada ao fim da anterior
+  pipeline->on_response = [this](const QByteArray &data) {
+    trace_writer.append(TraceSource::Poll, data);
+    begin_trace(pipeline->last_request_sent_ns(), pipeline->last_response_ns());
+    apply_verse_state(detect_verse(QString::fromUtf8(data)));
+  };
+  // "presentation": null vs. objeto aparece logo no início do corpo
+  pipeline->on_partial = [this](const QByteArray &received) {
+    // Gravando: lê sempre o corpo inteiro para o trace
+    if (trace_writer.is_open())
+      return false;
+    begin_trace(pipeline->last_request_sent_ns(), pipeline->last_response_ns());
+    const bool was_visible = verse_was_visible;
+    if (!detect_verse_partial(received))
+      return false;
+    // O corpo em cache não representa mais o estado: a volta a ele
+    // precisa ser reavaliada
+    if (verse_was_visible != was_visible)
+      pipeline->reset_cache();
+    return true;
+  };
+  pipeline->on_error = [this](const QString &error) {
+    // Cada falha só em debug: o aviso sai na abertura do circuito
+    log(LogLevel::Debug, "[Auto Hide DEBUG] Erro de conexão com ProPresent: %s",
+        error.toUtf8().constData());
+    // Reserva pronta: troca na hora, sem passar por "sem resposta"
+    if (!failover->report_failure())
+      set_reachable(false);
+  };
+  pipeline->on_success = [this]() {
+    failover->report_success();
+    set_reachable(true);
+  };
+
+  pipeline->on_state_changed = [this](ConnectionState state) {
+    set_connection_state(state);
+  };
+
+  failover = new EndpointFailover(network_manager, this);
+  failover->set_probe_path("/version");
+  failover->on_switched = [this](const QString &url) { switch_endpoint(url); };
 
-  // Configurar timer
-  polling_timer.setTimerType(Qt::PreciseTimer);
-  QObject::connect(&polling_timer, &QTimer::timeout, this,
-                   &ProPresentClient::check_view);
+  stream_retry_timer.setSingleShot(true);
+  stream_retry_timer.setInterval(kStreamRetryMs);
+  QObject::connect(&stream_retry_timer, &QTimer::timeout, this,
+                   &ProPresentClient::open_stream);
+
+  status_stream->on_opened = [this]() {
+    // Stream ativo: o polling vira redundante
+    pipeline->stop();
+    set_connection_state(ConnectionState::Connected);
+    log(LogLevel::Info, "[Auto Hide] ProPresent: stream de status conectado");
+  };
+  status_stream->on_message = [this](const QByteArray &message) {
+    on_stream_message(message);
+  };
+  status_stream->on_dropped = [this](const QString &reason) {
+    on_stream_dropped(reason);
+  };
 }
 
 ProPresentClient::~ProPresentClient() { disconnect(); }
 
 void ProPresentClient::connect(const QString &url) {
-  base_url = url;
-  if (base_url.endsWith("/")) {
-    base_url.chop(1);
+  // Pode ser chamado da thread da UI: executa na thread do cliente
+  if (QThread::currentThread() != thread()) {
+    QMetaObject::invokeMethod(
+        this, [this, url]() { connect(url); }, Qt::QueuedConnection);
+    return;
+  }
+
+  // Principal primeiro, depois as reservas na ordem
+  QStringList endpoints;
+  for (QString endpoint : QStringList(url) + backup_urls) {
+    if (endpoint.endsWith("/"))
+      endpoint.chop(1);
+    endpoints.append(endpoint);
   }
+  failover->set_endpoints(endpoints);
+  base_url = failover->active_url();
 
-  polling_timer.setInterval(polling_interval_ms);
-  polling_timer.start();
   connected = true;
 
-  blog(LOG_INFO, "[Auto Hide] Conectando ao ProPresent em: %s",
-       base_url.toUtf8().constData());
+  log(LogLevel::Info, "[Auto Hide] Conectando ao ProPresent em: %s",
+      base_url.toUtf8().constData());
 
-  // Primeira verificação imediata
-  check_view();
+  // O polling roda até o stream confirmar que está recebendo dados.
+  // start() já faz a primeira verificação imediata.
+  pipeline->set_url(QUrl(base_url + "/v1/presentation/active"));
+  pipeline->set_interval(polling_interval_ms);
+  pipeline->start();
+  failover->start();
+
+  if (push_mode) {
+    open_stream();
+  }
+
+  start_trace_capture();
 }
 
 void ProPresentClient::disconnect() {
-  polling_timer.stop();
+  // Bloqueia até parar de fato: nenhuma consulta nova depois do retorno
+  if (QThread::currentThread() != thread()) {
+    QMetaObject::invokeMethod(
+        this, [this]() { disconnect(); }, Qt::BlockingQueuedConnection);
+    return;
+  }
+
+  if (connected) {
+    const PollStats &stats = pipeline->stats();
+    log(LogLevel::Info,
+        "[Auto Hide] ProPresent: %llu consultas, %llu sem mudança (ignoradas)",
+        (unsigned long long)stats.requests,
+        (unsigned long long)stats.skipped());
+  }
+
+  pipeline->stop();
+  failover->stop();
+  stream_retry_timer.stop();
+  status_stream->close();
+  trace_writer.close();
   connected = false;
   verse_was_visible = false;
-  blog(LOG_INFO, "[Auto Hide] Desconectado do ProPresent");
+  reachable = false;
+  connection_state = ConnectionState::Connected;
+  log(LogLevel::Info, "[Auto Hide] Desconectado do ProPresent");
 }
 
 bool ProPresentClient::is_connected() { return connected; }
 
+void ProPresentClient::set_poll_scheduler(PollScheduler *scheduler) {
+  pipeline->set_scheduler(scheduler);
+}
+
+void ProPresentClient::set_backup_urls(const QStringList &urls) {
+  backup_urls = urls;
+}
+
+void ProPresentClient::switch_endpoint(const QString &url) {
+  // verse_was_visible fica como está: a troca não deve piscar as fontes
+  base_url = url;
+  pipeline->set_url(QUrl(base_url + "/v1/presentation/active"));
+  if (pipeline->is_running() && !pipeline->is_in_flight())
+    pipeline->poll_now();
+  if (push_mode) {
+    stream_retry_timer.stop();
+    status_stream->close();
+    open_stream();
+  }
+}
+
+void ProPresentClient::set_connection_state(ConnectionState state) {
+  if (connection_state == state)
+    return;
+
+  const ConnectionState previous = std::exchange(connection_state, state);
+  if (state == ConnectionState::OpenCircuit &&
+      previous != ConnectionState::Probing) {
+    log(LogLevel::Warning,
+        "[Auto Hide] ProPresent fora do ar: consultas suspensas, nova tentativa em "
+        "~%d s",
+        pipeline->backoff_ms() / 1000);
+  } else if (state == ConnectionState::Connected &&
+             previous != ConnectionState::Degraded) {
+    log(LogLevel::Info, "[Auto Hide] ProPresent respondendo novamente");
+  } else {
+    log(LogLevel::Debug, "[Auto Hide DEBUG] Conexão com ProPresent: %s",
+        connection_state_name(state));
+  }
+
+  if (on_connection_state_changed)
+    on_connection_state_changed(state);
+}
+
+void ProPresentClient::set_reachable(bool value) {
+  if (reachable == value)
+    return;
+  reachable = value;
+  if (on_reachability_changed)
+    on_reachability_changed(value);
+}
+
 void ProPresentClient::set_polling_interval(int ms) {
   polling_interval_ms = ms;
-  if (connected) {
-    polling_timer.setInterval(ms);
-  }
+  pipeline->set_interval(ms);
 }
 
 void ProPresentClient::set_disable_in_music(bool disable) {
     disable_in_music = disable; // Mantido para consistência da Interface de Configuração se for adicionar grupos futuramente.
 }
 
-void ProPresentClient::check_view() {
+void ProPresentClient::set_transport(PipelineTransport transport) {
+  pipeline->set_transport(transport);
+}
+
+void ProPresentClient::set_push_mode(bool enabled) {
+  if (push_mode == enabled)
+    return;
+
+  push_mode = enabled;
   if (!connected)
     return;
 
-  QString url = base_url + "/v1/presentation/active";
+  if (push_mode) {
+    open_stream();
+  } else {
+    stream_retry_timer.stop();
+    status_stream->close();
+    pipeline->start();
+  }
+}
+
+void ProPresentClient::set_trace_capture(const QString &directory) {
+  if (trace_directory == directory)
+    return;
+
+  trace_directory = directory;
+  if (connected) {
+    start_trace_capture();
+  }
+}
+
+void ProPresentClient::start_trace_capture() {
+  trace_writer.close();
+  if (trace_directory.isEmpty())
+    return;
+
+  QString path = trace_directory + "/propresent-" +
+                 QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss") +
+                 ".aht";
+  if (trace_writer.open(path, TraceClient::ProPresent)) {
+    log(LogLevel::Info, "[Auto Hide] Gravando trace do feed em: %s",
+        path.toUtf8().constData());
+    // O estado atual entra no trace já na próxima resposta
+    pipeline->reset_cache();
+  }
+}
+
+void ProPresentClient::feed_recorded(TraceSource source,
+                                     const QByteArray &body) {
+  if (source == TraceSource::Stream) {
+    on_stream_message(body);
+    return;
+  }
 
-  QNetworkRequest request(url);
-  request.setTransferTimeout(2000); // 2 segundos timeout
+  const uint64_t now = os_gettime_ns();
+  begin_trace(now, now);
+  apply_verse_state(detect_verse(QString::fromUtf8(body)));
+}
+
+void ProPresentClient::open_stream() {
+  if (!connected || !push_mode)
+    return;
+
+  QNetworkRequest request(QUrl(base_url + "/v1/status/updates"));
   request.setHeader(QNetworkRequest::UserAgentHeader, "OBS Auto Hide Plugin");
+  status_stream->open(request, QByteArray(kStreamTopics));
+}
 
-  QNetworkReply *reply = network_manager->get(request);
+void ProPresentClient::on_stream_message(const QByteArray &message) {
+  trace_writer.append(TraceSource::Stream, message);
+  set_reachable(true);
 
-  QObject::connect(reply, &QNetworkReply::finished, [this, reply, url]() {
-    if (reply->error() != QNetworkReply::NoError) {
-      if (polling_timer.isActive()) {
-        blog(LOG_WARNING, "[Auto Hide] Erro de conexão com ProPresent: %s",
-             reply->errorString().toUtf8().constData());
-      }
+  // Sem requisição no push: a contagem começa na chegada da mensagem
+  const uint64_t now = os_gettime_ns();
+  begin_trace(now, now);
+
+  QJsonDocument doc = QJsonDocument::fromJson(message);
+  if (!doc.isObject())
+    return;
+
+  QJsonObject update = doc.object();
+  QString topic = update.value("url").toString();
+  QJsonValue data = update.value("data");
+
+  if (topic == "presentation/active") {
+    // Mesmo corpo de GET /v1/presentation/active
+    QJsonObject body = data.toObject();
+    apply_verse_state(body.contains("presentation") &&
+                      !body.value("presentation").isNull());
+  } else if (topic == "presentation/slide_index") {
+    QJsonObject body = data.toObject();
+    if (body.contains("presentation_index")) {
+      apply_verse_state(!body.value("presentation_index").isNull());
     } else {
-      QByteArray data = reply->readAll();
-      QString json_str = QString::fromUtf8(data);
+      // Formato inesperado: confirma com uma consulta pontual
+      pipeline->poll_now();
+    }
+  }
+}
 
-      bool verse_visible = detect_verse(json_str);
+void ProPresentClient::on_stream_dropped(const QString &reason) {
+  if (!connected)
+    return;
 
-      if (verse_visible != verse_was_visible) {
-        verse_was_visible = verse_visible;
+  log(LogLevel::Warning,
+      "[Auto Hide] ProPresent: stream de status caiu (%s), voltando ao polling",
+      reason.toUtf8().constData());
 
-        blog(LOG_INFO, "[Auto Hide] ProPresent Estado mudou: Apresentação ativa %s",
-             verse_visible ? "SIM" : "NÃO");
+  // Volta ao polling e tenta reabrir o stream mais tarde
+  pipeline->start();
+  stream_retry_timer.start();
+}
 
-        if (on_verse_changed) {
-          on_verse_changed(verse_visible);
-        }
-      }
-    }
+void ProPresentClient::begin_trace(uint64_t request_sent_ns, uint64_t response_ns) {
+  current_trace = TransitionTrace();
+  current_trace.request_sent_ns = request_sent_ns;
+  current_trace.response_received_ns = response_ns;
+}
+
+void ProPresentClient::apply_verse_state(bool verse_visible) {
+  if (verse_visible == verse_was_visible)
+    return;
+
+  verse_was_visible = verse_visible;
 
-    reply->deleteLater();
-  });
+  log(LogLevel::Info, "[Auto Hide] ProPresent Estado mudou: Apresentação ativa %s",
+      verse_visible ? "SIM" : "NÃO");
+
+  if (on_verse_changed) {
+    TransitionTrace trace = current_trace;
+    trace.detected_ns = os_gettime_ns();
+    on_verse_changed(verse_visible, trace);
+  }
 }
 
 bool ProPresentClient::detect_verse(const QString &raw_data) {
@@ -116,9 +371,20 @@ bool ProPresentClient::detect_verse(const QString &raw_data) {
   return false;
 }
 
-void ProPresentClient::log(const char *format, ...) {
+bool ProPresentClient::detect_verse_partial(const QByteArray &received) {
+  PresentationActiveView view;
+  // Completo ou inválido: deixa para o caminho normal no fim da resposta
+  if (scan_presentation_active(received, view) != ScanStatus::Truncated ||
+      !view.has_presentation)
+    return false;
+
+  apply_verse_state(!view.presentation_null);
+  return true;
+}
+
+void ProPresentClient::log(LogLevel level, const char *format, ...) {
   va_list args;
   va_start(args, format);
-  blog(LOG_INFO, format, args);
+  PluginLog::write_va(level, format, args);
   va_end(args);
 }
@@ -1,10 +1,16 @@
 #pragma once
 
+#include "endpoint-failover.hpp"
+#include "feed-trace.hpp"
+#include "plugin-log.hpp"
 #include "presentation-client.hpp"
+#include "request-pipeline.hpp"
+#include "status-stream.hpp"
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QObject>
 #include <QTimer>
+#include <atomic>
 
 class ProPresentClient : public QObject, public IPresentationClient {
   Q_OBJECT
@@ -16,25 +22,66 @@ public:
   void connect(const QString &url) override;
   void disconnect() override;
   bool is_connected() override;
+  void set_poll_scheduler(PollScheduler *scheduler) override;
+  void set_backup_urls(const QStringList &urls) override;
 
   // Configuração
   void set_polling_interval(int ms);
   // Nota: Deixado compatível com HolyricsClient caso seja útil futuramente
   void set_disable_in_music(bool disable);
+  // Push: assina /v1/status/updates em vez de consultar a cada tick
+  void set_push_mode(bool enabled);
 
-private slots:
-  void check_view();
+  // Transporte HTTP do polling (QNetworkAccessManager ou keep-alive)
+  void set_transport(PipelineTransport transport);
+
+  // Contadores de polling (consultas puladas por conteúdo igual)
+  const PollStats &poll_stats() const { return pipeline->stats(); }
+
+  // Gravação do feed: um trace novo a cada connect() no diretório dado
+  // (vazio = desligado)
+  void set_trace_capture(const QString &directory);
+  // Reprodução: entrega um corpo gravado como se tivesse acabado de chegar
+  void feed_recorded(TraceSource source, const QByteArray &body);
 
 private:
   QNetworkAccessManager *network_manager;
-  QTimer polling_timer;
+  RequestPipeline *pipeline;
+  EndpointFailover *failover;
+  QStringList backup_urls;
+  StatusStream *status_stream;
+  QTimer stream_retry_timer;
+  bool push_mode = false;
   QString base_url;
-  bool connected = false;
+  std::atomic<bool> connected{false};
   bool verse_was_visible = false;
+  bool reachable = false;
+  ConnectionState connection_state = ConnectionState::Connected;
   int polling_interval_ms = 1000;
   bool disable_in_music = false;
 
   bool detect_verse(const QString &json_str);
+  // Decisão antecipada sobre o corpo ainda incompleto (true = decidido)
+  bool detect_verse_partial(const QByteArray &received);
+  void apply_verse_state(bool verse_visible);
+  void set_reachable(bool value);
+  void set_connection_state(ConnectionState state);
+  // Failover: mesma sessão, só a URL base muda
+  void switch_endpoint(const QString &url);
+
+  // Latência: momentos da resposta em avaliação
+  TransitionTrace current_trace;
+  void begin_trace(uint64_t request_sent_ns, uint64_t response_ns);
+
+  // Trace do feed
+  FeedTraceWriter trace_writer;
+  QString trace_directory;
+  void start_trace_capture();
+
+  // Push mode
+  void open_stream();
+  void on_stream_message(const QByteArray &message);
+  void on_stream_dropped(const QString &reason);
 
-  void log(const char *format, ...);
+  void log(LogLevel level, const char *format, ...);
 };
@@ -0,0 +1,345 @@
+#include "request-pipeline.hpp"
+#include <QHash>
+#include <QNetworkRequest>
+#include <util/platform.h>
+
+RequestPipeline::RequestPipeline(QNetworkAccessManager *manager,
+                                 QObject *parent)
+    : QObject(parent), network_manager(manager), next_poll_timer(this) {
+  next_poll_timer.setSingleShot(true);
+  next_poll_timer.setTimerType(Qt::PreciseTimer);
+  QObject::connect(&next_poll_timer, &QTimer::timeout, this,
+                   &RequestPipeline::send_request);
+}
+
+RequestPipeline::~RequestPipeline() { stop(); }
+
+void RequestPipeline::set_url(const QUrl &new_url) {
+  if (url == new_url)
+    return;
+
+  url = new_url;
+  reset_cache();
+  // Falhas eram da URL antiga
+  if (breaker.reset())
+    notify_state();
+  // Resposta em voo é da URL antiga: descarta e consulta a nova
+  if (running && is_in_flight()) {
+    abort_in_flight();
+    send_request();
+  } else {
+    prewarm_keepalive();
+  }
+}
+
+void RequestPipeline::set_interval(int ms) { interval_ms = ms; }
+
+void RequestPipeline::set_scheduler(PollScheduler *new_scheduler,
+                                    PollPriority priority) {
+  if (scheduler == new_scheduler && poll_priority == priority)
+    return;
+
+  // Uma consulta já agendada passa para o agendador novo
+  cancel_next();
+  scheduler = new_scheduler;
+  poll_priority = priority;
+  schedule_next();
+}
+
+void RequestPipeline::run_scheduled_poll() {
+  if (running)
+    send_request();
+}
+
+void RequestPipeline::cancel_next() {
+  next_poll_timer.stop();
+  if (scheduler)
+    scheduler->cancel(this);
+}
+
+void RequestPipeline::set_transfer_timeout(int ms) { transfer_timeout_ms = ms; }
+
+void RequestPipeline::start() {
+  if (running)
+    return;
+
+  running = true;
+  // Outro caminho (stream) pode ter mudado o estado enquanto estava parado
+  reset_cache();
+  send_request();
+}
+
+void RequestPipeline::stop() {
+  running = false;
+  poll_requested = false;
+  cancel_next();
+  abort_in_flight();
+}
+
+void RequestPipeline::poll_now() {
+  if (is_in_flight()) {
+    // Single-flight: a próxima sai assim que esta terminar
+    poll_requested = true;
+    return;
+  }
+  cancel_next();
+  send_request();
+}
+
+void RequestPipeline::reset_cache() {
+  last_etag.clear();
+  last_body_hash = 0;
+  last_body_size = -1;
+}
+
+void RequestPipeline::set_transport(PipelineTransport new_transport) {
+  if (transport == new_transport)
+    return;
+
+  abort_in_flight();
+  transport = new_transport;
+
+  if (transport == PipelineTransport::KeepAlive && !keepalive) {
+    keepalive = new KeepAliveTransport(this);
+    keepalive->on_progress = [this](quint64 sequence, QByteArrayView body) {
+      if (sequence != current_sequence || partial_decided || !on_partial)
+        return;
+      // Só lê o buffer fixo, sem cópia
+      feed_partial(QByteArray::fromRawData(body.data(), body.size()));
+    };
+    keepalive->on_complete = [this](quint64 sequence, int status,
+                                    QByteArrayView body,
+                                    const QByteArray &etag) {
+      if (sequence != current_sequence)
+        return;
+      keepalive_in_flight = false;
+      handle_body(status, QByteArray::fromRawData(body.data(), body.size()),
+                  etag);
+    };
+    keepalive->on_failed = [this](quint64 sequence, const QString &error) {
+      if (sequence != current_sequence)
+        return;
+      keepalive_in_flight = false;
+      handle_error(error);
+    };
+  } else if (transport == PipelineTransport::Qt && keepalive) {
+    keepalive->close();
+  }
+  prewarm_keepalive();
+
+  if (running)
+    send_request();
+}
+
+void RequestPipeline::prewarm_keepalive() {
+  // Conexão aberta mesmo com o ciclo parado (ex.: stream ativo): a primeira
+  // consulta do fallback não paga o handshake
+  if (transport == PipelineTransport::KeepAlive && keepalive &&
+      KeepAliveTransport::supports(url))
+    keepalive->set_url(url);
+}
+
+void RequestPipeline::send_request() {
+  if (is_in_flight() || !url.isValid())
+    return;
+
+  partial_decided = false;
+  if (breaker.begin_request())
+    notify_state();
+
+  if (transport == PipelineTransport::KeepAlive &&
+      KeepAliveTransport::supports(url)) {
+    send_keepalive_request();
+    return;
+  }
+
+  QNetworkRequest request(url);
+  request.setTransferTimeout(transfer_timeout_ms);
+  request.setHeader(QNetworkRequest::UserAgentHeader, "OBS Auto Hide Plugin");
+  if (!last_etag.isEmpty()) {
+    request.setRawHeader("If-None-Match", last_etag);
+  }
+
+  poll_stats.requests++;
+  request_sent_ns = os_gettime_ns();
+  const quint64 sequence = ++current_sequence;
+  QNetworkReply *reply = network_manager->get(request);
+  in_flight = reply;
+  partial_body.clear();
+
+  if (on_partial) {
+    QObject::connect(reply, &QNetworkReply::readyRead, this,
+                     [this, reply, sequence]() {
+                       on_reply_ready_read(reply, sequence);
+                     });
+  }
+
+  QObject::connect(reply, &QNetworkReply::finished, this,
+                   [this, reply, sequence]() {
+                     on_reply_finished(reply, sequence);
+                   });
+}
+
+void RequestPipeline::send_keepalive_request() {
+  // URL/timeout podem ter mudado; set_url só reconecta se o host mudar
+  keepalive->set_url(url);
+  keepalive->set_transfer_timeout(transfer_timeout_ms);
+
+  poll_stats.requests++;
+  request_sent_ns = os_gettime_ns();
+  const quint64 sequence = ++current_sequence;
+  // Marca antes: uma falha pode ser reportada de dentro do send()
+  keepalive_in_flight = true;
+  if (!keepalive->send(sequence, last_etag)) {
+    keepalive_in_flight = false;
+    handle_error("Transporte keep-alive indisponível");
+  }
+}
+
+void RequestPipeline::on_reply_ready_read(QNetworkReply *reply,
+                                          quint64 sequence) {
+  if (reply != in_flight || sequence != current_sequence)
+    return;
+
+  // Só corpo de sucesso interessa (304/erros seguem pelo finished)
+  if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() !=
+      200)
+    return;
+
+  partial_body.append(reply->readAll());
+
+  if (!feed_partial(partial_body))
+    return;
+
+  // Decidido: descarta o resto da resposta
+  abort_in_flight();
+  partial_body.clear();
+  notify_success();
+  schedule_next();
+}
+
+bool RequestPipeline::feed_partial(const QByteArray &received) {
+  response_received_ns = os_gettime_ns();
+  if (!on_partial(received))
+    return false;
+
+  partial_decided = true;
+  poll_stats.early_aborts++;
+  // Corpo incompleto: não entra no cache. ETag/hash seguem os do último
+  // corpo completo (quem decidiu invalida se o estado mudou).
+  return true;
+}
+
+void RequestPipeline::on_reply_finished(QNetworkReply *reply,
+                                        quint64 sequence) {
+  reply->deleteLater();
+
+  // Resposta de um ciclo anterior: ignora
+  if (reply != in_flight || sequence != current_sequence)
+    return;
+
+  in_flight = nullptr;
+
+  if (reply->error() != QNetworkReply::NoError) {
+    handle_error(reply->errorString());
+    return;
+  }
+
+  // No caminho incremental parte do corpo já foi lida no readyRead
+  QByteArray data = partial_body + reply->readAll();
+  partial_body.clear();
+  handle_body(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(),
+              data, reply->rawHeader("ETag"));
+}
+
+void RequestPipeline::handle_error(const QString &error) {
+  poll_stats.errors++;
+  // Antes do callback: um failover nele recomeça a contagem na URL nova
+  if (breaker.record_failure())
+    notify_state();
+  if (on_error) {
+    on_error(error);
+  }
+  // O callback pode ter parado o pipeline
+  schedule_next();
+}
+
+void RequestPipeline::handle_body(int status, const QByteArray &data,
+                                  const QByteArray &etag) {
+  response_received_ns = os_gettime_ns();
+  if (partial_decided) {
+    // Keep-alive: o resto foi lido só para manter a conexão utilizável;
+    // a resposta já decidida não vai para o cache
+  } else if (status == 304) {
+    // Servidor confirmou via ETag que nada mudou
+    poll_stats.not_modified++;
+  } else if (status < 200 || status >= 300) {
+    handle_error(QString("HTTP %1").arg(status));
+    return;
+  } else {
+    size_t body_hash = qHash(data);
+
+    if (data.size() == last_body_size && body_hash == last_body_hash) {
+      poll_stats.unchanged++;
+    } else {
+      last_etag = etag;
+      last_body_hash = body_hash;
+      last_body_size = data.size();
+      if (on_response) {
+        on_response(data);
+      }
+    }
+  }
+
+  notify_success();
+  // O callback pode ter parado o pipeline
+  schedule_next();
+}
+
+void RequestPipeline::abort_in_flight() {
+  if (keepalive_in_flight) {
+    keepalive_in_flight = false;
+    ++current_sequence;
+    keepalive->cancel();
+  }
+
+  if (!in_flight)
+    return;
+
+  QNetworkReply *reply = in_flight;
+  in_flight = nullptr;
+  // Invalida a sequência para que uma resposta tardia seja descartada
+  ++current_sequence;
+  QObject::disconnect(reply, nullptr, this, nullptr);
+  reply->abort();
+  reply->deleteLater();
+}
+
+void RequestPipeline::schedule_next() {
+  if (!running || is_in_flight())
+    return;
+
+  if (poll_requested) {
+    poll_requested = false;
+    send_request();
+    return;
+  }
+
+  const int delay_ms = breaker.next_delay_ms(interval_ms);
+  if (scheduler)
+    scheduler->schedule(this, delay_ms, poll_priority);
+  else
+    next_poll_timer.start(delay_ms);
+}
+
+void RequestPipeline::notify_success() {
+  if (breaker.record_success())
+    notify_state();
+  if (on_success)
+    on_success();
+}
+
+void RequestPipeline::notify_state() {
+  if (on_state_changed)
+    on_state_changed(breaker.state());
+}
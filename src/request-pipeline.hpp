@@ -0,0 +1,139 @@
+#pragma once
+
+#include "connection-breaker.hpp"
+#include "keepalive-transport.hpp"
+#include "poll-scheduler.hpp"
+#include <QByteArray>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QUrl>
+#include <functional>
+
+// Contadores do pipeline (para diagnóstico)
+struct PollStats {
+  quint64 requests = 0;     // Requisições enviadas
+  quint64 not_modified = 0; // HTTP 304 (ETag igual)
+  quint64 unchanged = 0;    // Corpo com o mesmo hash da resposta anterior
+  quint64 errors = 0;
+  quint64 early_aborts = 0; // Decididas no meio do corpo (resto abortado)
+
+  quint64 skipped() const { return not_modified + unchanged; }
+};
+
+// Como as consultas saem: QNetworkAccessManager (padrão) ou a conexão
+// keep-alive enxuta de KeepAliveTransport (só http://)
+enum class PipelineTransport { Qt, KeepAlive };
+
+// Pipeline de polling com no máximo UMA requisição em voo por cliente.
+// A próxima consulta é agendada a partir do fim da resposta anterior (e não
+// por um timer fixo), e cada resposta leva um número de sequência: respostas
+// atrasadas de um ciclo anterior (stop/start, troca de URL) são descartadas.
+// Respostas iguais à anterior (304 via ETag ou mesmo hash do corpo) não
+// chegam ao on_response: a detecção só roda quando o conteúdo muda.
+class RequestPipeline : public QObject {
+  Q_OBJECT
+
+public:
+  explicit RequestPipeline(QNetworkAccessManager *manager,
+                           QObject *parent = nullptr);
+  ~RequestPipeline() override;
+
+  // No transporte keep-alive a conexão já é aberta aqui, antes da consulta
+  void set_url(const QUrl &url);
+  void set_interval(int ms);
+  void set_transfer_timeout(int ms);
+  void set_transport(PipelineTransport transport);
+  int interval() const { return interval_ms; }
+  // Agendador compartilhado entre clientes (nullptr = timer próprio)
+  void set_scheduler(PollScheduler *scheduler,
+                     PollPriority priority = PollPriority::Normal);
+  // Chamado pelo PollScheduler quando chega a vez deste pipeline
+  void run_scheduled_poll();
+
+  // Inicia o ciclo com uma consulta imediata
+  void start();
+  // Para o ciclo e descarta a resposta em voo, se houver
+  void stop();
+  bool is_running() const { return running; }
+  bool is_in_flight() const {
+    return in_flight != nullptr || keepalive_in_flight;
+  }
+
+  // Consulta fora do ciclo. Se já houver uma em voo, só antecipa a próxima.
+  void poll_now();
+
+  // Esquece a última resposta: a próxima sempre chega ao on_response
+  void reset_cache();
+  const PollStats &stats() const { return poll_stats; }
+
+  // Circuit breaker: com o servidor fora do ar as consultas viram
+  // sondagens espaçadas (backoff exponencial com jitter)
+  ConnectionState connection_state() const { return breaker.state(); }
+  int backoff_ms() const { return breaker.backoff_ms(); }
+
+  // Momentos (os_gettime_ns) da consulta atual: válidos dentro dos callbacks
+  uint64_t last_request_sent_ns() const { return request_sent_ns; }
+  uint64_t last_response_ns() const { return response_received_ns; }
+
+  // Chamados apenas para a resposta mais recente do ciclo atual
+  std::function<void(const QByteArray &body)> on_response;
+  std::function<void(const QString &error)> on_error;
+  // Toda resposta válida, inclusive 304 e corpos iguais (servidor no ar)
+  std::function<void()> on_success;
+  // Mudança de estado da conexão (ver ConnectionBreaker)
+  std::function<void(ConnectionState state)> on_state_changed;
+
+  // Opcional: recebe o corpo acumulado a cada readyRead. Se retornar true,
+  // a decisão já foi tomada: o resto da resposta é abortado e on_response
+  // não é chamado para esta consulta. Essa resposta não entra no cache;
+  // se a decisão mudou o estado, chame reset_cache() (um 304 do corpo
+  // antigo não pode ser tomado como "nada mudou").
+  std::function<bool(const QByteArray &received)> on_partial;
+
+private:
+  QNetworkAccessManager *network_manager;
+  KeepAliveTransport *keepalive = nullptr;
+  PipelineTransport transport = PipelineTransport::Qt;
+  bool keepalive_in_flight = false;
+  QTimer next_poll_timer;
+  PollScheduler *scheduler = nullptr;
+  PollPriority poll_priority = PollPriority::Normal;
+  QUrl url;
+  QNetworkReply *in_flight = nullptr;
+  quint64 current_sequence = 0;
+  bool running = false;
+  bool poll_requested = false;
+  int interval_ms = 1000;
+  int transfer_timeout_ms = 2000;
+
+  // Última resposta entregue
+  QByteArray last_etag;
+  size_t last_body_hash = 0;
+  qsizetype last_body_size = -1;
+  PollStats poll_stats;
+  ConnectionBreaker breaker;
+  uint64_t request_sent_ns = 0;
+  uint64_t response_received_ns = 0;
+
+  // Corpo recebido até agora (caminho incremental)
+  QByteArray partial_body;
+  // on_partial já decidiu esta consulta (keep-alive lê o resto sem abortar)
+  bool partial_decided = false;
+
+  void send_request();
+  void prewarm_keepalive();
+  void send_keepalive_request();
+  void on_reply_ready_read(QNetworkReply *reply, quint64 sequence);
+  void on_reply_finished(QNetworkReply *reply, quint64 sequence);
+  bool feed_partial(const QByteArray &received);
+  void handle_error(const QString &error);
+  void handle_body(int status, const QByteArray &data, const QByteArray &etag);
+  void abort_in_flight();
+  void schedule_next();
+  void cancel_next();
+  void notify_success();
+  void notify_state();
+};
@@ -1,15 +1,89 @@
 #include "scene-controller.hpp"
+#include "plugin-log.hpp"
 #include <obs-module.h>
 #include <obs-frontend-api.h>
+#include <algorithm>
+#include <util/platform.h>
+#include <utility>
 
-SceneController::SceneController(QObject *parent) : QObject(parent) {}
+SceneController::SceneController(QObject *parent) : QObject(parent) {
+  // Timer é membro: morre junto com o controller, nada dispara depois
+  action_timer.setSingleShot(true);
+  connect(&action_timer, &QTimer::timeout, this,
+          &SceneController::run_pending_action);
 
-SceneController::~SceneController() {}
+  obs_frontend_add_event_callback(on_frontend_event, this);
+}
 
-void SceneController::set_action_delay(int ms) { action_delay_ms = ms; }
+SceneController::~SceneController() {
+  // Depois de obs_remove_tick_callback nenhum tick está em andamento
+  set_frame_aligned(false);
+  cancel_pending_actions();
+  clear_saved_items();
+  obs_frontend_remove_event_callback(on_frontend_event, this);
+}
+
+void SceneController::on_frontend_event(enum obs_frontend_event event,
+                                        void *data) {
+  auto *self = static_cast<SceneController *>(data);
+
+  // Troca de cena não invalida nada (o cache é por cena); só mudanças na
+  // lista de cenas ou na coleção, que podem destruir as cenas em cache
+  switch (event) {
+  case OBS_FRONTEND_EVENT_SCENE_COLLECTION_CHANGING:
+  case OBS_FRONTEND_EVENT_SCENE_COLLECTION_CLEANUP:
+  case OBS_FRONTEND_EVENT_EXIT:
+    // Itens da coleção antiga não podem sobreviver a ela
+    self->release_prearm();
+    self->drop_frame_batch();
+    self->clear_saved_items();
+    self->sources_hidden = false;
+    self->item_cache.clear();
+    break;
+  case OBS_FRONTEND_EVENT_SCENE_LIST_CHANGED:
+  case OBS_FRONTEND_EVENT_SCENE_COLLECTION_CHANGED:
+    self->item_cache.clear();
+    break;
+  case OBS_FRONTEND_EVENT_PREVIEW_SCENE_CHANGED:
+    // Operador trocou o Preview preparado: a preparação não vale mais
+    if (self->prearm.scene_source) {
+      obs_source_t *preview = obs_frontend_get_current_preview_scene();
+      if (preview != self->prearm.scene_source)
+        self->disarm_prearm();
+      obs_source_release(preview);
+    }
+    break;
+  default:
+    break;
+  }
+}
 
 void SceneController::set_auto_transition(bool enabled) { auto_transition = enabled; }
 
+void SceneController::set_all_scenes(bool enabled) {
+  if (enabled == all_scenes)
+    return;
+  // Estado salvo de um modo não serve para o outro
+  disarm_prearm();
+  all_scenes = enabled;
+  sources_hidden = false;
+  clear_saved_items();
+  saved_states.clear();
+}
+
+void SceneController::set_frame_aligned(bool enabled) {
+  if (enabled == frame_aligned)
+    return;
+
+  frame_aligned = enabled;
+  if (enabled) {
+    obs_add_tick_callback(on_video_tick, this);
+  } else {
+    obs_remove_tick_callback(on_video_tick, this);
+    drop_frame_batch();
+  }
+}
+
 QStringList SceneController::get_available_scenes() {
   QStringList scenes;
   struct obs_frontend_source_list source_list = {};
@@ -33,171 +107,478 @@ QStringList SceneController::get_scene_sources(const QString &scene_name) {
   if (!scene_source)
     return sources;
 
-  obs_scene_t *scene = obs_scene_from_source(scene_source);
-  if (scene) {
-    obs_scene_enum_items(
-        scene,
-        [](obs_scene_t *, obs_sceneitem_t *item, void *param) {
-          QStringList *list = static_cast<QStringList *>(param);
-          obs_source_t *source = obs_sceneitem_get_source(item);
-          const char *name = obs_source_get_name(source);
-          list->append(QString::fromUtf8(name));
-          return true;
-        },
-        &sources);
-  }
+  // Inclui fontes de cenas aninhadas e grupos (árvore achatada do cache)
+  if (obs_scene_from_source(scene_source))
+    sources = item_cache.source_names(scene_source);
 
   obs_source_release(scene_source);
   return sources;
 }
 
-void SceneController::save_current_state(const QStringList &source_names) {
+void SceneController::save_current_state(obs_source_t *scene_source,
+                                         const QStringList &source_names) {
   saved_states.clear();
 
-  obs_source_t *current_scene_source = obs_frontend_get_current_scene();
-  if (!current_scene_source)
-    return;
-
-  obs_scene_t *scene = obs_scene_from_source(current_scene_source);
-  if (!scene) {
-    obs_source_release(current_scene_source);
-    return;
-  }
-
-  for (const QString &name : source_names) {
-    obs_sceneitem_t *item =
-        obs_scene_find_source(scene, name.toUtf8().constData());
+  const auto &items = item_cache.resolve(scene_source, source_names);
+  for (size_t i = 0; i < items.size(); i++) {
+    obs_sceneitem_t *item = items[i];
     if (item) {
+      const QString &name = source_names[static_cast<qsizetype>(i)];
       SourceState state;
       state.name = name;
       state.was_visible = obs_sceneitem_visible(item);
       saved_states[name] = state;
     }
   }
+}
 
-  obs_source_release(current_scene_source);
+void SceneController::save_all_scenes_state(const QStringList &source_names) {
+  clear_saved_items();
+  for (const QString &name : source_names) {
+    for (obs_sceneitem_t *item : item_cache.items_for_source(name)) {
+      obs_sceneitem_addref(item);
+      saved_items.push_back({item, obs_sceneitem_visible(item)});
+    }
+  }
 }
 
-void SceneController::hide_sources(const QStringList &source_names) {
-  save_current_state(source_names);
+void SceneController::clear_saved_items() {
+  for (const auto &saved : saved_items)
+    obs_sceneitem_release(saved.item);
+  saved_items.clear();
+}
 
-  // Usar QTimer::singleShot para debouncing/delay
-  QTimer::singleShot(action_delay_ms, [this, source_names]() {
-    bool is_studio = obs_frontend_preview_program_mode_active();
-    obs_source_t *target_scene_source = (is_studio && auto_transition)
-                                            ? obs_frontend_get_current_preview_scene()
-                                            : obs_frontend_get_current_scene();
+obs_source_t *SceneController::get_target_scene(bool &is_studio) const {
+  is_studio = obs_frontend_preview_program_mode_active();
+  return (is_studio && auto_transition) ? obs_frontend_get_current_preview_scene()
+                                        : obs_frontend_get_current_scene();
+}
 
-    if (!target_scene_source)
-      return;
+void SceneController::queue_change(obs_sceneitem_t *item, bool visible) {
+  pending_batch.push_back({obs_sceneitem_get_scene(item), item, visible});
+}
 
-    obs_scene_t *scene = obs_scene_from_source(target_scene_source);
-    if (!scene) {
-      obs_source_release(target_scene_source);
-      return;
+static void apply_changes(std::vector<VisibilityChange> &changes) {
+  // Um obs_scene_atomic_update por cena: o render vê o estado antigo ou o
+  // novo, nunca parte das fontes escondidas
+  std::stable_sort(changes.begin(), changes.end(),
+                   [](const VisibilityChange &a, const VisibilityChange &b) {
+                     return std::less<obs_scene_t *>()(a.scene, b.scene);
+                   });
+
+  struct Range {
+    const VisibilityChange *begin;
+    const VisibilityChange *end;
+  };
+
+  size_t begin = 0;
+  while (begin < changes.size()) {
+    size_t end = begin + 1;
+    while (end < changes.size() && changes[end].scene == changes[begin].scene)
+      end++;
+
+    Range range = {changes.data() + begin, changes.data() + end};
+    if (changes[begin].scene) {
+      obs_scene_atomic_update(
+          changes[begin].scene,
+          [](void *data, obs_scene_t *) {
+            const Range *r = static_cast<const Range *>(data);
+            for (const VisibilityChange *c = r->begin; c != r->end; c++)
+              obs_sceneitem_set_visible(c->item, c->visible);
+          },
+          &range);
     }
+    begin = end;
+  }
+}
 
-    int count = 0;
-    for (const QString &name : source_names) {
-      obs_sceneitem_t *item =
-          obs_scene_find_source(scene, name.toUtf8().constData());
-      if (item && obs_sceneitem_visible(item)) {
-        obs_sceneitem_set_visible(item, false);
-        count++;
-      }
-    }
+int SceneController::commit_batch() {
+  const int count = static_cast<int>(pending_batch.size());
+  if (count == 0)
+    return 0;
 
-    obs_source_release(target_scene_source);
+  apply_changes(pending_batch);
+  pending_batch.clear();
+  return count;
+}
 
-    if (count > 0) {
-      blog(LOG_INFO, "[Auto Hide] Escondeu %d fontes", count);
-      if (is_studio && auto_transition) {
-          obs_frontend_preview_program_trigger_transition();
-          blog(LOG_INFO, "[Auto Hide] Acionada transição do Modo Estúdio");
-      }
+void SceneController::finish_action(int count, bool is_studio,
+                                    TransitionTrace &trace,
+                                    const char *verb) {
+  if (trace.applied_ns == 0)
+    trace.applied_ns = os_gettime_ns();
+  report_transition(trace);
+
+  if (count > 0) {
+    blog(LOG_INFO, "[Auto Hide] %s %d fontes", verb, count);
+    // Uma transição por lote, depois que todas as fontes mudaram
+    if (is_studio && auto_transition) {
+      obs_frontend_preview_program_trigger_transition();
+      blog(LOG_INFO, "[Auto Hide] Acionada transição do Modo Estúdio");
     }
-  });
+  }
 }
 
-void SceneController::restore_previous_state() {
-  QTimer::singleShot(action_delay_ms, [this]() {
-    bool is_studio = obs_frontend_preview_program_mode_active();
-    obs_source_t *target_scene_source = (is_studio && auto_transition)
-                                            ? obs_frontend_get_current_preview_scene()
-                                            : obs_frontend_get_current_scene();
+void SceneController::hide_sources(const QStringList &source_names,
+                                   const TransitionTrace &trace) {
+  submit_action(SceneAction::Hide, source_names, trace);
+}
 
-    if (!target_scene_source)
-      return;
+void SceneController::restore_previous_state(const TransitionTrace &trace) {
+  submit_action(SceneAction::Restore, QStringList(), trace);
+}
 
-    obs_scene_t *scene = obs_scene_from_source(target_scene_source);
-    if (!scene) {
-      obs_source_release(target_scene_source);
+void SceneController::show_all_sources(const QStringList &source_names,
+                                       const TransitionTrace &trace) {
+  submit_action(SceneAction::ShowAll, source_names, trace);
+}
+
+void SceneController::submit_action(SceneAction action,
+                                    const QStringList &source_names,
+                                    const TransitionTrace &trace) {
+  // O último pedido vence: um alvo ainda pendente é descartado
+  if (pending_action.armed) {
+    superseded_actions++;
+    PluginLog::write(LogLevel::Debug,
+                     "[Auto Hide DEBUG] Ação pendente substituída (%llu no total)",
+                     static_cast<unsigned long long>(superseded_actions));
+  }
+
+  pending_action.action = action;
+  pending_action.source_names = source_names;
+  pending_action.trace = trace;
+  pending_action.generation = ++action_generation;
+  pending_action.armed = true;
+
+  // Sem atraso aqui (a confirmação fica no VerseStateFilter): aplica na
+  // próxima volta do event loop, juntando pedidos da mesma volta
+  action_timer.start(0);
+}
+
+void SceneController::prearm_hide(const QStringList &source_names) {
+  // Já escondidas (ou Preview já preparado): nada a adiantar
+  if (sources_hidden || source_names.isEmpty())
+    return;
+
+  release_prearm();
+  prearm.armed = true;
+  // Resolução pelo cache agora: no hide a árvore já está montada
+  pending_batch.reserve(static_cast<size_t>(source_names.size()));
+
+  if (all_scenes) {
+    for (const QString &name : source_names)
+      item_cache.items_for_source(name);
+    PluginLog::write(LogLevel::Debug,
+                     "[Auto Hide DEBUG] Hide pré-armado (todas as cenas)");
+    return;
+  }
+
+  bool is_studio = false;
+  obs_source_t *target_scene_source = get_target_scene(is_studio);
+  if (!target_scene_source)
+    return;
+  if (!obs_scene_from_source(target_scene_source)) {
+    obs_source_release(target_scene_source);
+    return;
+  }
+  item_cache.resolve(target_scene_source, source_names);
+
+  // Preview diferente do Programa: dá para esconder antes, fora do ar
+  if (is_studio && auto_transition) {
+    obs_source_t *program_source = obs_frontend_get_current_scene();
+    const bool separate = program_source != target_scene_source;
+    obs_source_release(program_source);
+
+    if (separate) {
+      collect_scene_changes(target_scene_source, SceneAction::Hide,
+                            source_names);
+      prearm.staged_count = commit_batch();
+      prearm.scene_source = target_scene_source;
+      blog(LOG_INFO,
+           "[Auto Hide] Preview preparado: %d fontes escondidas antes da "
+           "transição",
+           prearm.staged_count);
       return;
     }
+  }
 
-    int count = 0;
-    for (const auto &[name, state] : saved_states) {
-      // Só restaura se estava visível ANTES
-      if (state.was_visible) {
-        obs_sceneitem_t *item =
-            obs_scene_find_source(scene, name.toUtf8().constData());
-        if (item && !obs_sceneitem_visible(item)) {
-          obs_sceneitem_set_visible(item, true);
-          count++;
-        }
-      }
-    }
+  obs_source_release(target_scene_source);
+  PluginLog::write(LogLevel::Debug, "[Auto Hide DEBUG] Hide pré-armado");
+}
 
-    obs_source_release(target_scene_source);
+void SceneController::disarm_prearm() {
+  if (!prearm.armed)
+    return;
 
-    if (count > 0) {
-      blog(LOG_INFO, "[Auto Hide] Restaurou %d fontes", count);
-      if (is_studio && auto_transition) {
-          obs_frontend_preview_program_trigger_transition();
-          blog(LOG_INFO, "[Auto Hide] Acionada transição do Modo Estúdio");
-      }
-    }
-  });
+  if (prearm.scene_source) {
+    // Desfaz só o que a preparação escondeu (estado salvo no prearm)
+    collect_scene_changes(prearm.scene_source, SceneAction::Restore,
+                          QStringList());
+    const int count = commit_batch();
+    blog(LOG_INFO, "[Auto Hide] Preview preparado desfeito (%d fontes)", count);
+  }
+  release_prearm();
+}
+
+void SceneController::release_prearm() {
+  if (prearm.scene_source)
+    obs_source_release(prearm.scene_source);
+  prearm = PrearmedHide();
 }
 
-void SceneController::show_all_sources(const QStringList &source_names) {
-  QTimer::singleShot(action_delay_ms, [this, source_names]() {
-    bool is_studio = obs_frontend_preview_program_mode_active();
-    obs_source_t *target_scene_source = (is_studio && auto_transition)
-                                            ? obs_frontend_get_current_preview_scene()
-                                            : obs_frontend_get_current_scene();
+bool SceneController::take_staged_preview(TransitionTrace &trace,
+                                          const char *verb) {
+  if (!prearm.scene_source || all_scenes)
+    return false;
+
+  bool is_studio = false;
+  obs_source_t *target_scene_source = get_target_scene(is_studio);
+  const bool same = target_scene_source == prearm.scene_source;
+  obs_source_release(target_scene_source);
+  if (!same)
+    return false;
 
+  const int count = prearm.staged_count;
+  release_prearm();
+  PluginLog::write(LogLevel::Debug,
+                   "[Auto Hide DEBUG] Hide pré-armado: só a transição");
+  finish_action(count, is_studio, trace, verb);
+  return true;
+}
+
+void SceneController::cancel_pending_actions() {
+  disarm_prearm();
+  action_timer.stop();
+  pending_action.armed = false;
+  pending_action.source_names.clear();
+  action_generation++;
+  drop_frame_batch();
+}
+
+void SceneController::run_pending_action() {
+  if (!pending_action.armed || pending_action.generation != action_generation)
+    return;
+
+  pending_action.armed = false;
+  const SceneAction action = pending_action.action;
+  const QStringList source_names = std::move(pending_action.source_names);
+  TransitionTrace trace = pending_action.trace;
+  pending_action.source_names.clear();
+
+  apply_action(action, source_names, trace);
+}
+
+void SceneController::apply_action(SceneAction action,
+                                   const QStringList &source_names,
+                                   TransitionTrace &trace) {
+  if (trace.timer_fired_ns == 0)
+    trace.timer_fired_ns = os_gettime_ns();
+
+  const char *verb = action == SceneAction::Hide      ? "Escondeu"
+                     : action == SceneAction::Restore ? "Restaurou"
+                                                      : "Mostrou";
+  // Preview já preparado pelo pré-armar: a troca custa só a transição
+  if (action == SceneAction::Hide && take_staged_preview(trace, verb))
+    return;
+  // Previsão não confirmada (ou outra cena): volta ao caminho normal
+  disarm_prearm();
+
+  bool is_studio = false;
+  if (all_scenes) {
+    // Todas as cenas já mudam juntas: sem transição do Modo Estúdio
+    collect_all_scenes_changes(action, source_names);
+  } else {
+    obs_source_t *target_scene_source = get_target_scene(is_studio);
     if (!target_scene_source)
       return;
+    if (obs_scene_from_source(target_scene_source))
+      collect_scene_changes(target_scene_source, action, source_names);
+    obs_source_release(target_scene_source);
+  }
 
-    obs_scene_t *scene = obs_scene_from_source(target_scene_source);
-    if (!scene) {
-      obs_source_release(target_scene_source);
-      return;
+  // Modo alinhado ao quadro: o tick de vídeo aplica e finish_action roda
+  // depois, de volta na thread da UI
+  if (frame_aligned && !pending_batch.empty()) {
+    queue_frame_batch(is_studio, trace, verb);
+    return;
+  }
+
+  const int count = commit_batch();
+  finish_action(count, is_studio, trace, verb);
+}
+
+void SceneController::collect_scene_changes(obs_source_t *scene_source,
+                                            SceneAction action,
+                                            const QStringList &source_names) {
+  switch (action) {
+  case SceneAction::Hide:
+    // Só salva se as fontes ainda não estão escondidas por nós; senão um
+    // hide repetido salvaria o próprio estado escondido
+    if (!sources_hidden)
+      save_current_state(scene_source, source_names);
+    sources_hidden = true;
+    for (obs_sceneitem_t *item : item_cache.resolve(scene_source, source_names)) {
+      if (item && obs_sceneitem_visible(item))
+        queue_change(item, false);
     }
+    break;
 
-    int count = 0; // Initialize count for this function
+  case SceneAction::Restore:
+    // Nada a restaurar se o hide foi substituído antes de ser aplicado
+    if (!sources_hidden)
+      break;
+    sources_hidden = false;
+    for (const auto &[name, state] : saved_states) {
+      // Só restaura se estava visível ANTES
+      if (!state.was_visible)
+        continue;
+      obs_sceneitem_t *item = item_cache.find(scene_source, name);
+      if (item && !obs_sceneitem_visible(item))
+        queue_change(item, true);
+    }
+    break;
+
+  case SceneAction::ShowAll:
+    sources_hidden = false;
+    for (obs_sceneitem_t *item : item_cache.resolve(scene_source, source_names)) {
+      if (item && !obs_sceneitem_visible(item))
+        queue_change(item, true);
+    }
+    break;
+  }
+}
+
+void SceneController::collect_all_scenes_changes(
+    SceneAction action, const QStringList &source_names) {
+  switch (action) {
+  case SceneAction::Hide:
+    if (!sources_hidden)
+      save_all_scenes_state(source_names);
+    sources_hidden = true;
     for (const QString &name : source_names) {
-      obs_sceneitem_t *item =
-          obs_scene_find_source(scene, name.toUtf8().constData());
-      if (item) {
-        if (!obs_sceneitem_visible(item)) {
-          obs_sceneitem_set_visible(item, true);
-          count++;
-        }
+      for (obs_sceneitem_t *item : item_cache.items_for_source(name)) {
+        if (obs_sceneitem_visible(item))
+          queue_change(item, false);
       }
     }
+    break;
+
+  case SceneAction::Restore:
+    if (!sources_hidden)
+      break;
+    sources_hidden = false;
+    for (const auto &saved : saved_items) {
+      if (saved.was_visible && !obs_sceneitem_visible(saved.item))
+        queue_change(saved.item, true);
+    }
+    clear_saved_items();
+    break;
 
-    obs_source_release(target_scene_source);
-
-    if (count > 0) {
-      blog(LOG_INFO, "[Auto Hide] Mostrou %d fontes", count); // Added blog message
-      if (is_studio && auto_transition) {
-          obs_frontend_preview_program_trigger_transition();
-          blog(LOG_INFO, "[Auto Hide] Acionada transição do Modo Estúdio");
+  case SceneAction::ShowAll:
+    sources_hidden = false;
+    for (const QString &name : source_names) {
+      for (obs_sceneitem_t *item : item_cache.items_for_source(name)) {
+        if (!obs_sceneitem_visible(item))
+          queue_change(item, true);
       }
     }
-  });
+    break;
+  }
+}
+
+void SceneController::queue_frame_batch(bool is_studio,
+                                        const TransitionTrace &trace,
+                                        const char *verb) {
+  // Referências próprias: o tick roda na thread de vídeo
+  std::vector<obs_source_t *> scene_refs;
+  for (const auto &change : pending_batch) {
+    obs_sceneitem_addref(change.item);
+    obs_source_t *scene_source = obs_scene_get_source(change.scene);
+    if (scene_source &&
+        std::find(scene_refs.begin(), scene_refs.end(), scene_source) ==
+            scene_refs.end())
+      scene_refs.push_back(scene_source);
+  }
+  for (obs_source_t *&scene_source : scene_refs)
+    scene_source = obs_source_get_ref(scene_source);
+
+  FrameBatch previous;
+  {
+    std::lock_guard<std::mutex> lock(frame_mutex);
+    if (frame_batch.armed)
+      superseded_actions++;
+    previous = std::exchange(frame_batch, FrameBatch());
+    frame_batch.scene_refs = std::move(scene_refs);
+    frame_batch.changes.swap(pending_batch);
+    frame_batch.trace = trace;
+    frame_batch.is_studio = is_studio;
+    frame_batch.verb = verb;
+    frame_batch.queued_frame = frame_counter.load();
+    frame_batch.armed = true;
+  }
+  pending_batch.clear();
+  release_frame_batch(previous);
+}
+
+void SceneController::drop_frame_batch() {
+  FrameBatch previous;
+  {
+    std::lock_guard<std::mutex> lock(frame_mutex);
+    previous = std::exchange(frame_batch, FrameBatch());
+  }
+  release_frame_batch(previous);
+}
+
+void SceneController::release_frame_batch(FrameBatch &batch) {
+  for (const auto &change : batch.changes)
+    obs_sceneitem_release(change.item);
+  batch.changes.clear();
+  for (obs_source_t *scene_source : batch.scene_refs)
+    obs_source_release(scene_source);
+  batch.scene_refs.clear();
+  batch.armed = false;
+}
+
+void SceneController::on_video_tick(void *data, float) {
+  auto *self = static_cast<SceneController *>(data);
+  const uint64_t frame = ++self->frame_counter;
+
+  FrameBatch batch;
+  {
+    std::lock_guard<std::mutex> lock(self->frame_mutex);
+    if (!self->frame_batch.armed)
+      return;
+    batch = std::exchange(self->frame_batch, FrameBatch());
+  }
+
+  // Início do tick, antes do render deste quadro
+  apply_changes(batch.changes);
+
+  TransitionTrace trace = batch.trace;
+  trace.applied_ns = os_gettime_ns();
+  const int count = static_cast<int>(batch.changes.size());
+  const bool is_studio = batch.is_studio;
+  const char *verb = batch.verb;
+  const uint64_t waited_frames = frame - batch.queued_frame;
+  self->release_frame_batch(batch);
+
+  // Transição do Modo Estúdio e UI só na thread da UI
+  QMetaObject::invokeMethod(
+      self,
+      [self, count, is_studio, trace, verb, waited_frames]() mutable {
+        PluginLog::write(LogLevel::Debug,
+                         "[Auto Hide DEBUG] Lote aplicado no tick após %llu "
+                         "quadro(s)",
+                         static_cast<unsigned long long>(waited_frames));
+        self->finish_action(count, is_studio, trace, verb);
+      },
+      Qt::QueuedConnection);
+}
+
+void SceneController::report_transition(const TransitionTrace &trace) {
+  if (trace.is_valid() && on_transition_applied) {
+    on_transition_applied(trace);
+  }
 }
 
 bool SceneController::is_source_visible(const QString &source_name) {
@@ -209,8 +590,7 @@ bool SceneController::is_source_visible(const QString &source_name) {
   bool visible = false;
 
   if (scene) {
-    obs_sceneitem_t *item =
-        obs_scene_find_source(scene, source_name.toUtf8().constData());
+    obs_sceneitem_t *item = item_cache.find(current_scene_source, source_name);
     if (item) {
       visible = obs_sceneitem_visible(item);
     }
@@ -228,8 +608,7 @@ void SceneController::set_source_visibility(const QString &source_name,
 
   obs_scene_t *scene = obs_scene_from_source(current_scene_source);
   if (scene) {
-    obs_sceneitem_t *item =
-        obs_scene_find_source(scene, source_name.toUtf8().constData());
+    obs_sceneitem_t *item = item_cache.find(current_scene_source, source_name);
     if (item) {
       obs_sceneitem_set_visible(item, visible);
     }
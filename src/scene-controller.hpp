@@ -1,11 +1,60 @@
 #pragma once
 
+#include "latency-stats.hpp"
+#include "scene-item-cache.hpp"
 #include <QObject>
 #include <QString>
 #include <QStringList>
 #include <QTimer>
+#include <functional>
+#include <atomic>
 #include <map>
+#include <mutex>
+#include <obs-frontend-api.h>
 #include <obs.h>
+#include <vector>
+
+// Uma mudança de visibilidade pendente no lote atual
+struct VisibilityChange {
+  obs_scene_t *scene; // Cena dona do item (um atomic_update por cena)
+  obs_sceneitem_t *item;
+  bool visible;
+};
+
+// Estado de um item antes do hide (modo todas as cenas), com addref
+struct SavedItemState {
+  obs_sceneitem_t *item;
+  bool was_visible;
+};
+
+enum class SceneAction { Hide, Restore, ShowAll };
+
+// Único estado-alvo pendente do executor (o último pedido vence)
+struct PendingAction {
+  SceneAction action = SceneAction::Hide;
+  QStringList source_names;
+  TransitionTrace trace;
+  quint64 generation = 0;
+  bool armed = false;
+};
+
+// Lote entregue ao tick de vídeo (modo alinhado ao quadro)
+struct FrameBatch {
+  std::vector<obs_source_t *> scene_refs; // Cenas afetadas, com referência
+  std::vector<VisibilityChange> changes;  // Itens com addref
+  TransitionTrace trace;
+  bool is_studio = false;
+  const char *verb = "";
+  uint64_t queued_frame = 0;
+  bool armed = false;
+};
+
+// Hide pré-armado pelo próximo item da apresentação
+struct PrearmedHide {
+  obs_source_t *scene_source = nullptr; // Preview já preparado, com referência
+  int staged_count = 0;                 // Fontes escondidas no Preview
+  bool armed = false;
+};
 
 struct SourceState {
   QString name;
@@ -23,23 +72,97 @@ public:
   QStringList get_available_scenes();
   QStringList get_scene_sources(const QString &scene_name);
 
-  // Ações principais
-  void hide_sources(const QStringList &source_names);
-  void restore_previous_state();
-  void show_all_sources(const QStringList &source_names); // Fallback
+  // Ações principais. trace (opcional) recebe o momento da aplicação e é
+  // entregue em on_transition_applied.
+  void hide_sources(const QStringList &source_names,
+                    const TransitionTrace &trace = TransitionTrace());
+  void restore_previous_state(const TransitionTrace &trace = TransitionTrace());
+  void show_all_sources(const QStringList &source_names,
+                        const TransitionTrace &trace = TransitionTrace()); // Fallback
 
   // Utilitários de visibilidade
   bool is_source_visible(const QString &source_name);
   void set_source_visibility(const QString &source_name, bool visible);
 
+  // Próximo item vai esconder as fontes: resolve os itens antes e, no Modo
+  // Estúdio com Preview diferente do Programa, já esconde no Preview. O
+  // hide seguinte só aciona a transição.
+  void prearm_hide(const QStringList &source_names);
+  // Previsão desfeita: devolve o Preview preparado ao estado anterior
+  void disarm_prearm();
+
+  // Descarta a ação ainda não aplicada (desconexão/troca de cliente)
+  void cancel_pending_actions();
+  // Ações substituídas por um pedido mais novo antes de serem aplicadas
+  quint64 superseded_count() const { return superseded_actions; }
+
   // Configuração
-  void set_action_delay(int ms);
   void set_auto_transition(bool enabled);
+  // Aplica em todas as cenas que contêm as fontes, não só na atual/preview
+  void set_all_scenes(bool enabled);
+  // Aplica as mudanças no início do próximo tick de vídeo
+  void set_frame_aligned(bool enabled);
+  bool is_frame_aligned() const { return frame_aligned; }
+
+  // Chamado ao fim de cada ação com trace válido (medição de latência)
+  std::function<void(const TransitionTrace &trace)> on_transition_applied;
 
 private:
   std::map<QString, SourceState> saved_states;
-  int action_delay_ms = 150;
   bool auto_transition = true;
+  bool all_scenes = false;
+  // Fontes escondidas por nós (saved_states/saved_items guardam o antes)
+  bool sources_hidden = false;
+  std::vector<SavedItemState> saved_items;
+
+  // Executor de ações: um alvo pendente + geração
+  QTimer action_timer;
+  PendingAction pending_action;
+  quint64 action_generation = 0;
+  quint64 superseded_actions = 0;
+  PrearmedHide prearm;
+
+  // Modo alinhado ao quadro: único lote pendente, consumido pelo tick
+  bool frame_aligned = false;
+  std::mutex frame_mutex;
+  FrameBatch frame_batch;
+  std::atomic<uint64_t> frame_counter{0};
+
+  // Itens resolvidos por cena (limpo em mudanças de lista/coleção de cenas)
+  SceneItemCache item_cache;
+  // Lote reaproveitado entre ações (sem alocação por ação)
+  std::vector<VisibilityChange> pending_batch;
+
+  void save_current_state(obs_source_t *scene_source,
+                          const QStringList &source_names);
+  void save_all_scenes_state(const QStringList &source_names);
+  void clear_saved_items();
+  void submit_action(SceneAction action, const QStringList &source_names,
+                     const TransitionTrace &trace);
+  void run_pending_action();
+  // Hide sobre o Preview já preparado: só falta a transição (true = feito)
+  bool take_staged_preview(TransitionTrace &trace, const char *verb);
+  void release_prearm();
+  void apply_action(SceneAction action, const QStringList &source_names,
+                    TransitionTrace &trace);
+  void collect_scene_changes(obs_source_t *scene_source, SceneAction action,
+                             const QStringList &source_names);
+  void collect_all_scenes_changes(SceneAction action,
+                                  const QStringList &source_names);
+  void queue_change(obs_sceneitem_t *item, bool visible);
+  obs_source_t *get_target_scene(bool &is_studio) const;
+  // Aplica pending_batch (um obs_scene_atomic_update por cena); devolve
+  // quantas fontes mudaram
+  int commit_batch();
+  void finish_action(int count, bool is_studio, TransitionTrace &trace,
+                     const char *verb);
+  void report_transition(const TransitionTrace &trace);
+  void queue_frame_batch(bool is_studio, const TransitionTrace &trace,
+                         const char *verb);
+  void drop_frame_batch();
+  void release_frame_batch(FrameBatch &batch);
+
+  static void on_video_tick(void *data, float seconds);
 
-  void save_current_state(const QStringList &source_names);
+  static void on_frontend_event(enum obs_frontend_event event, void *data);
 };
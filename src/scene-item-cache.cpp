@@ -0,0 +1,257 @@
+#include "scene-item-cache.hpp"
+#include <algorithm>
+#include <obs-frontend-api.h>
+
+// Sinais da cena que mudam o conjunto de itens
+static const char *kSceneSignals[] = {"item_add", "item_remove", "refresh"};
+
+SceneItemCache::SceneItemCache() {
+  signal_handler_connect(obs_get_signal_handler(), "source_rename",
+                         on_source_renamed, this);
+}
+
+SceneItemCache::~SceneItemCache() {
+  signal_handler_disconnect(obs_get_signal_handler(), "source_rename",
+                            on_source_renamed, this);
+  clear();
+}
+
+void SceneItemCache::on_items_changed(void *data, calldata_t *) {
+  Entry *entry = static_cast<Entry *>(data);
+  entry->dirty = true;
+  entry->owner->any_dirty = true;
+}
+
+void SceneItemCache::on_source_renamed(void *data, calldata_t *) {
+  auto *self = static_cast<SceneItemCache *>(data);
+  self->epoch++;
+  self->any_dirty = true;
+}
+
+SceneItemCache::Entry *SceneItemCache::entry_for(obs_source_t *scene_source) {
+  auto it = entries.find(scene_source);
+  if (it == entries.end()) {
+    auto entry = std::make_unique<Entry>();
+    entry->owner = this;
+    // Segura a cena: os sinais continuam válidos até clear()
+    entry->scene_source = obs_source_get_ref(scene_source);
+    if (!entry->scene_source)
+      return nullptr;
+
+    signal_handler_t *handler =
+        obs_source_get_signal_handler(entry->scene_source);
+    for (const char *signal : kSceneSignals)
+      signal_handler_connect(handler, signal, on_items_changed, entry.get());
+
+    it = entries.emplace(scene_source, std::move(entry)).first;
+  }
+
+  Entry *entry = it->second.get();
+  if (entry->dirty || entry->built_epoch != epoch)
+    rebuild(*entry);
+  return entry;
+}
+
+// Limite de profundidade só por segurança: o OBS já impede ciclos
+static constexpr int kMaxNestingDepth = 16;
+
+void SceneItemCache::rebuild(Entry &entry) {
+  // Limpa antes de percorrer: um sinal durante a varredura suja de novo
+  entry.dirty = false;
+  entry.built_epoch = epoch;
+  if (all_scenes_tracked)
+    index_remove(entry);
+  release_items(entry);
+  unwatch_nested(entry);
+
+  obs_scene_t *scene = obs_group_or_scene_from_source(entry.scene_source);
+  if (scene)
+    collect_items(entry, scene, 0);
+
+  if (all_scenes_tracked)
+    index_add(entry);
+}
+
+void SceneItemCache::collect_items(Entry &entry, obs_scene_t *scene,
+                                   int depth) {
+  // Percorre este nível antes de descer: a ordem é a mesma de
+  // obs_scene_find_source no topo e nenhum lock de cena fica aninhado
+  std::vector<obs_source_t *> nested;
+  struct Context {
+    Entry *entry;
+    std::vector<obs_source_t *> *nested;
+  } context = {&entry, &nested};
+
+  obs_scene_enum_items(
+      scene,
+      [](obs_scene_t *, obs_sceneitem_t *item, void *param) {
+        auto *ctx = static_cast<Context *>(param);
+        obs_source_t *source = obs_sceneitem_get_source(item);
+        QString name = QString::fromUtf8(obs_source_get_name(source));
+        // Nome repetido: vale o primeiro (o mais raso)
+        if (!ctx->entry->items_by_name.contains(name)) {
+          obs_sceneitem_addref(item);
+          ctx->entry->items_by_name.insert(name, item);
+          ctx->entry->ordered_names.append(name);
+        }
+        if (obs_group_or_scene_from_source(source))
+          ctx->nested->push_back(obs_source_get_ref(source));
+        return true;
+      },
+      &context);
+
+  for (obs_source_t *source : nested) {
+    const bool seen = std::find(entry.watched.begin(), entry.watched.end(),
+                                source) != entry.watched.end();
+    obs_scene_t *child = obs_group_or_scene_from_source(source);
+    if (seen || !child || depth + 1 >= kMaxNestingDepth) {
+      obs_source_release(source);
+      continue;
+    }
+
+    // Mudanças dentro da cena aninhada/grupo também sujam esta entrada
+    signal_handler_t *handler = obs_source_get_signal_handler(source);
+    for (const char *signal : kSceneSignals)
+      signal_handler_connect(handler, signal, on_items_changed, &entry);
+    entry.watched.push_back(source);
+
+    collect_items(entry, child, depth + 1);
+  }
+}
+
+void SceneItemCache::unwatch_nested(Entry &entry) {
+  for (obs_source_t *source : entry.watched) {
+    signal_handler_t *handler = obs_source_get_signal_handler(source);
+    for (const char *signal : kSceneSignals)
+      signal_handler_disconnect(handler, signal, on_items_changed, &entry);
+    obs_source_release(source);
+  }
+  entry.watched.clear();
+}
+
+void SceneItemCache::release_items(Entry &entry) {
+  for (obs_sceneitem_t *item : entry.items_by_name)
+    obs_sceneitem_release(item);
+  entry.items_by_name.clear();
+  entry.ordered_names.clear();
+  entry.resolved_names.clear();
+  entry.resolved_items.clear();
+}
+
+const std::vector<obs_sceneitem_t *> &
+SceneItemCache::resolve(obs_source_t *scene_source, const QStringList &names) {
+  Entry *entry = entry_for(scene_source);
+  if (!entry)
+    return empty_items;
+
+  if (entry->resolved_names != names || entry->resolved_items.empty()) {
+    entry->resolved_names = names;
+    entry->resolved_items.clear();
+    entry->resolved_items.reserve(names.size());
+    for (const QString &name : names)
+      entry->resolved_items.push_back(entry->items_by_name.value(name));
+  }
+  return entry->resolved_items;
+}
+
+obs_sceneitem_t *SceneItemCache::find(obs_source_t *scene_source,
+                                      const QString &name) {
+  Entry *entry = entry_for(scene_source);
+  return entry ? entry->items_by_name.value(name) : nullptr;
+}
+
+void SceneItemCache::destroy_entry(Entry *entry) {
+  signal_handler_t *handler =
+      obs_source_get_signal_handler(entry->scene_source);
+  for (const char *signal : kSceneSignals)
+    signal_handler_disconnect(handler, signal, on_items_changed, entry);
+
+  unwatch_nested(*entry);
+  release_items(*entry);
+  obs_source_release(entry->scene_source);
+  entry->scene_source = nullptr;
+}
+
+void SceneItemCache::clear() {
+  for (auto &[source, entry] : entries)
+    destroy_entry(entry.get());
+  entries.clear();
+  source_index.clear();
+  all_scenes_tracked = false;
+}
+
+void SceneItemCache::track_all_scenes() {
+  struct obs_frontend_source_list scenes = {};
+  obs_frontend_get_scenes(&scenes);
+  for (size_t i = 0; i < scenes.sources.num; i++)
+    entry_for(scenes.sources.array[i]);
+  obs_frontend_source_list_free(&scenes);
+
+  source_index.clear();
+  for (const auto &[source, entry] : entries)
+    index_add(*entry);
+  all_scenes_tracked = true;
+  index_epoch = epoch;
+}
+
+void SceneItemCache::refresh_dirty_entries() {
+  if (!any_dirty.exchange(false) && index_epoch == epoch)
+    return;
+
+  index_epoch = epoch;
+  for (auto &[source, entry] : entries) {
+    if (entry->dirty || entry->built_epoch != epoch)
+      rebuild(*entry);
+  }
+}
+
+void SceneItemCache::index_add(const Entry &entry) {
+  for (auto it = entry.items_by_name.cbegin(); it != entry.items_by_name.cend();
+       ++it)
+    source_index[it.key()].push_back({&entry, it.value()});
+}
+
+void SceneItemCache::index_remove(const Entry &entry) {
+  for (auto it = entry.items_by_name.cbegin(); it != entry.items_by_name.cend();
+       ++it) {
+    auto index_it = source_index.find(it.key());
+    if (index_it == source_index.end())
+      continue;
+    // Só as referências desta entrada: o mesmo item pode vir de outra cena
+    // que contém esta como aninhada
+    auto &refs = index_it.value();
+    refs.erase(std::remove_if(refs.begin(), refs.end(),
+                              [&entry](const IndexRef &ref) {
+                                return ref.entry == &entry;
+                              }),
+               refs.end());
+    if (refs.empty())
+      source_index.erase(index_it);
+  }
+}
+
+const std::vector<obs_sceneitem_t *> &
+SceneItemCache::items_for_source(const QString &name) {
+  if (!all_scenes_tracked)
+    track_all_scenes();
+  else
+    refresh_dirty_entries();
+
+  index_items.clear();
+  auto it = source_index.constFind(name);
+  if (it == source_index.cend())
+    return index_items;
+
+  // Sem repetição: um item de cena aninhada aparece uma vez por cena pai
+  for (const IndexRef &ref : it.value()) {
+    if (std::find(index_items.begin(), index_items.end(), ref.item) ==
+        index_items.end())
+      index_items.push_back(ref.item);
+  }
+  return index_items;
+}
+
+QStringList SceneItemCache::source_names(obs_source_t *scene_source) {
+  Entry *entry = entry_for(scene_source);
+  return entry ? entry->ordered_names : QStringList();
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <atomic>
+#include <memory>
+#include <obs.h>
+#include <unordered_map>
+#include <vector>
+
+// Cache de itens de cena resolvidos por nome, uma entrada por cena.
+// Evita toUtf8() + obs_scene_find_source (busca linear) a cada ação: cada
+// cena é percorrida uma vez e as ações seguintes só andam por ponteiros já
+// resolvidos.
+//
+// A entrada é a árvore achatada da cena: itens de cenas aninhadas e grupos
+// entram também (o mais raso vence em nomes repetidos), e os sinais das
+// cenas aninhadas sujam a entrada da cena de cima.
+//
+// Uso apenas na thread da UI. Os sinais item_add/item_remove da cena (que
+// podem vir de outras threads) só marcam a entrada como suja; a
+// reconstrução acontece no próximo uso.
+class SceneItemCache {
+public:
+  SceneItemCache();
+  ~SceneItemCache();
+
+  SceneItemCache(const SceneItemCache &) = delete;
+  SceneItemCache &operator=(const SceneItemCache &) = delete;
+
+  // Itens na ordem de names (nullptr = fonte não está na cena). A
+  // referência vale até a próxima chamada.
+  const std::vector<obs_sceneitem_t *> &resolve(obs_source_t *scene_source,
+                                                const QStringList &names);
+  obs_sceneitem_t *find(obs_source_t *scene_source, const QString &name);
+
+  // Nomes das fontes da cena, incluindo cenas aninhadas e grupos
+  QStringList source_names(obs_source_t *scene_source);
+
+  // Índice reverso: itens da fonte em todas as cenas da coleção. Na
+  // primeira chamada (ou depois de clear) todas as cenas entram no cache;
+  // depois só as cenas que mudaram são refeitas. A referência vale até a
+  // próxima chamada.
+  const std::vector<obs_sceneitem_t *> &items_for_source(const QString &name);
+
+  // Solta todas as referências (troca/limpeza de coleção de cenas)
+  void clear();
+
+private:
+  struct Entry {
+    SceneItemCache *owner = nullptr;
+    obs_source_t *scene_source = nullptr; // Referência forte enquanto em cache
+    std::atomic<bool> dirty{true};
+    uint64_t built_epoch = 0;
+    QHash<QString, obs_sceneitem_t *> items_by_name; // Com addref
+    QStringList ordered_names; // Ordem de percurso (para listar na UI)
+    // Cenas aninhadas/grupos observados, com referência
+    std::vector<obs_source_t *> watched;
+    // Última lista resolvida (normalmente as fontes configuradas)
+    QStringList resolved_names;
+    std::vector<obs_sceneitem_t *> resolved_items;
+  };
+
+  std::unordered_map<obs_source_t *, std::unique_ptr<Entry>> entries;
+  // Incrementado em renomeações: todas as entradas ficam velhas
+  std::atomic<uint64_t> epoch{1};
+  std::vector<obs_sceneitem_t *> empty_items;
+
+  // Índice reverso (só depois de items_for_source)
+  bool all_scenes_tracked = false;
+  std::atomic<bool> any_dirty{false};
+  uint64_t index_epoch = 0;
+  struct IndexRef {
+    const Entry *entry;
+    obs_sceneitem_t *item;
+  };
+  QHash<QString, std::vector<IndexRef>> source_index;
+  std::vector<obs_sceneitem_t *> index_items;
+
+  Entry *entry_for(obs_source_t *scene_source);
+  void rebuild(Entry &entry);
+  void collect_items(Entry &entry, obs_scene_t *scene, int depth);
+  void unwatch_nested(Entry &entry);
+  void release_items(Entry &entry);
+  void destroy_entry(Entry *entry);
+  void track_all_scenes();
+  void refresh_dirty_entries();
+  void index_add(const Entry &entry);
+  void index_remove(const Entry &entry);
+
+  static void on_items_changed(void *data, calldata_t *params);
+  static void on_source_renamed(void *data, calldata_t *params);
+};
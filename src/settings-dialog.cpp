@@ -1,4 +1,5 @@
 #include "settings-dialog.hpp"
+#include "plugin-log.hpp"
 #include <QFormLayout>
 #include <QGroupBox>
 #include <QMessageBox>
@@ -189,6 +190,12 @@ void SettingsDialog::setup_ui() {
     url_input->setMinimumWidth(300);
     form_holyrics->addRow("URL Base:", url_input);
 
+    backup_urls_input = new QLineEdit(tab_connection);
+    backup_urls_input->setPlaceholderText("http://192.168.0.11:9000 (opcional)");
+    backup_urls_input->setToolTip("URLs reserva, separadas por espaço, em ordem de prioridade. Se a URL base parar de responder, o plugin troca na hora para a próxima que está respondendo e volta quando a principal responder de novo.");
+    backup_urls_input->setMinimumWidth(300);
+    form_holyrics->addRow("URLs reserva:", backup_urls_input);
+
     interval_input = new QSpinBox(tab_connection);
     interval_input->setRange(100, 10000);
     interval_input->setSuffix(" ms");
@@ -196,6 +203,39 @@ void SettingsDialog::setup_ui() {
     interval_input->setMinimumWidth(150);
     form_holyrics->addRow("Intervalo (Polling):", interval_input);
 
+    push_mode_check = new QCheckBox("Receber atualizações em tempo real (push)", tab_connection);
+    push_mode_check->setToolTip("Mantém uma conexão aberta com o software de apresentação e reage assim que o slide muda. Se a conexão cair, volta ao polling.");
+    form_holyrics->addRow("", push_mode_check);
+
+    stream_path_input = new QLineEdit(tab_connection);
+    stream_path_input->setPlaceholderText("Holyrics: caminho do stream de eventos");
+    stream_path_input->setToolTip("Endpoint do Holyrics que envia o mesmo JSON de /view/text.json a cada mudança (SSE ou JSON chunked). Usado apenas no modo push.");
+    stream_path_input->setMinimumWidth(300);
+    form_holyrics->addRow("Stream (Holyrics):", stream_path_input);
+
+    push_hint_label = new QLabel("⚠ Modo push inativo no Holyrics sem caminho de stream: continua no polling.", tab_connection);
+    push_hint_label->setStyleSheet("color: #ffcc00; font-size: 11px;");
+    push_hint_label->setWordWrap(true);
+    form_holyrics->addRow("", push_hint_label);
+
+    connect(push_mode_check, &QCheckBox::toggled, this, &SettingsDialog::update_push_hint);
+    connect(stream_path_input, &QLineEdit::textChanged, this, &SettingsDialog::update_push_hint);
+    connect(client_type_combo, &QComboBox::currentTextChanged, this, &SettingsDialog::update_push_hint);
+
+    next_item_path_input = new QLineEdit(tab_connection);
+    next_item_path_input->setPlaceholderText("Holyrics: playlist / próximo item (opcional)");
+    next_item_path_input->setToolTip("Endpoint do Holyrics com a playlist ou o próximo item. Se o próximo item for um versículo, o plugin deixa o hide pronto (e no Modo Estúdio prepara o Preview) antes da troca. Vazio = desligado.");
+    next_item_path_input->setMinimumWidth(300);
+    form_holyrics->addRow("Próximo item:", next_item_path_input);
+
+    transport_combo = new QComboBox(tab_connection);
+    transport_combo->addItem("Padrão (Qt)", "Qt");
+    transport_combo->addItem("Conexão persistente (keep-alive)", "KeepAlive");
+    transport_combo->setToolTip("Conexão persistente mantém um único socket TCP aberto e reaproveita a requisição e o buffer a cada consulta. Apenas http://.");
+    transport_combo->setCursor(Qt::PointingHandCursor);
+    transport_combo->setMinimumWidth(300);
+    form_holyrics->addRow("Transporte HTTP:", transport_combo);
+
     layout_holyrics->addLayout(form_holyrics);
 
     QHBoxLayout *test_layout = new QHBoxLayout();
@@ -215,6 +255,35 @@ void SettingsDialog::setup_ui() {
     connect(test_button, &QPushButton::clicked, this, &SettingsDialog::test_connection);
 
     layout_connection->addWidget(group_holyrics);
+
+    QGroupBox *group_extra = new QGroupBox("Clientes Adicionais", tab_connection);
+    QVBoxLayout *layout_extra = new QVBoxLayout(group_extra);
+    layout_extra->setSpacing(12);
+    layout_extra->setContentsMargins(5, 5, 5, 8);
+
+    QFormLayout *form_extra = new QFormLayout();
+    form_extra->setLabelAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    form_extra->setVerticalSpacing(12);
+    form_extra->setHorizontalSpacing(15);
+    form_extra->setFieldGrowthPolicy(QFormLayout::ExpandingFieldsGrow);
+
+    extra_clients_input = new QPlainTextEdit(tab_connection);
+    extra_clients_input->setPlaceholderText("ProPresent http://192.168.0.20:1025");
+    extra_clients_input->setToolTip("Um cliente por linha: software (Holyrics ou ProPresent), URL e, opcionalmente, URLs reserva. Rodam junto com o cliente principal.");
+    extra_clients_input->setMaximumHeight(70);
+    form_extra->addRow("Clientes:", extra_clients_input);
+
+    combine_combo = new QComboBox(tab_connection);
+    combine_combo->addItem("Qualquer um com versículo", "any");
+    combine_combo->addItem("Todos com versículo", "all");
+    combine_combo->addItem("Prioridade (primeiro que responde)", "priority");
+    combine_combo->setToolTip("Como combinar o estado dos clientes. Prioridade: o principal decide enquanto responde; se cair, o próximo da lista.");
+    combine_combo->setCursor(Qt::PointingHandCursor);
+    combine_combo->setMinimumWidth(300);
+    form_extra->addRow("Combinar:", combine_combo);
+
+    layout_extra->addLayout(form_extra);
+    layout_connection->addWidget(group_extra);
     layout_connection->addStretch();
 
     tab_widget->addTab(tab_connection, "🔌 Conexão");
@@ -283,11 +352,26 @@ void SettingsDialog::setup_ui() {
     form_behavior->setHorizontalSpacing(15);
     form_behavior->setFieldGrowthPolicy(QFormLayout::ExpandingFieldsGrow);
 
-    delay_input = new QSpinBox(tab_behavior);
-    delay_input->setRange(0, 5000);
-    delay_input->setSuffix(" ms");
-    delay_input->setMinimumWidth(150);
-    form_behavior->addRow("Delay de ação:", delay_input);
+    hide_confirm_input = new QSpinBox(tab_behavior);
+    hide_confirm_input->setRange(0, 5000);
+    hide_confirm_input->setSuffix(" ms");
+    hide_confirm_input->setMinimumWidth(150);
+    hide_confirm_input->setToolTip("Tempo que o versículo precisa ficar na tela antes de esconder as fontes.");
+    form_behavior->addRow("Confirmar versículo:", hide_confirm_input);
+
+    show_confirm_input = new QSpinBox(tab_behavior);
+    show_confirm_input->setRange(0, 5000);
+    show_confirm_input->setSuffix(" ms");
+    show_confirm_input->setMinimumWidth(150);
+    show_confirm_input->setToolTip("Tempo sem versículo antes de mostrar as fontes. Cobre o slide vazio entre versículos.");
+    form_behavior->addRow("Confirmar fim:", show_confirm_input);
+
+    min_dwell_input = new QSpinBox(tab_behavior);
+    min_dwell_input->setRange(0, 10000);
+    min_dwell_input->setSuffix(" ms");
+    min_dwell_input->setMinimumWidth(150);
+    min_dwell_input->setToolTip("Tempo mínimo entre duas mudanças nas fontes.");
+    form_behavior->addRow("Permanência mínima:", min_dwell_input);
 
     layout_behavior->addLayout(form_behavior);
     layout_behavior->addSpacing(5);
@@ -301,11 +385,66 @@ void SettingsDialog::setup_ui() {
     disable_in_music_check = new QCheckBox("Pausar monitoramento se for música", tab_behavior);
     layout_behavior->addWidget(disable_in_music_check);
 
+    QFormLayout *form_rules = new QFormLayout();
+    form_rules->setLabelAlignment(Qt::AlignRight | Qt::AlignTop);
+    form_rules->setHorizontalSpacing(15);
+    form_rules->setFieldGrowthPolicy(QFormLayout::ExpandingFieldsGrow);
+
+    content_rules_input = new QPlainTextEdit(tab_behavior);
+    content_rules_input->setToolTip("Uma regra por linha: TIPO = perfil. Tipos: BIBLE, MUSIC, TEXT, ANNOUNCEMENT, IMAGE, EMPTY (tela limpa), OTHER (demais) ou qualquer outro tipo do Holyrics. Perfis: show, hide, hide_if_text, keep, deactivate.");
+    content_rules_input->setMaximumHeight(110);
+    form_rules->addRow("Regras por tipo:", content_rules_input);
+    layout_behavior->addLayout(form_rules);
+
     auto_transition_check = new QCheckBox("Acionar transição automaticamente (Modo Estúdio)", tab_behavior);
     auto_transition_check->setToolTip("Se o Modo Estúdio estiver ligado, prepara as fontes na cena Preview e transiciona automaticamente para o Ao Vivo.");
     layout_behavior->addWidget(auto_transition_check);
 
+    frame_aligned_check = new QCheckBox("Alinhar mudanças ao quadro de vídeo", tab_behavior);
+    frame_aligned_check->setToolTip("Aplica as mudanças no início do próximo quadro do OBS, sem depender da carga da interface. A latência passa a ser mostrada também em quadros.");
+    layout_behavior->addWidget(frame_aligned_check);
+
+    all_scenes_check = new QCheckBox("Aplicar em todas as cenas que usam as fontes", tab_behavior);
+    all_scenes_check->setToolTip("Esconde/restaura as fontes em todas as cenas onde aparecem, não só na cena atual. Nesse modo a transição do Modo Estúdio não é acionada.");
+    layout_behavior->addWidget(all_scenes_check);
+
     layout_behavior_tab->addWidget(group_behavior);
+
+    QGroupBox *group_diagnostics = new QGroupBox("Diagnóstico", tab_behavior);
+    QVBoxLayout *layout_diagnostics = new QVBoxLayout(group_diagnostics);
+    layout_diagnostics->setSpacing(8);
+    layout_diagnostics->setContentsMargins(5, 5, 5, 8);
+
+    QFormLayout *form_diagnostics = new QFormLayout();
+    form_diagnostics->setLabelAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    form_diagnostics->setVerticalSpacing(12);
+    form_diagnostics->setHorizontalSpacing(15);
+    form_diagnostics->setFieldGrowthPolicy(QFormLayout::ExpandingFieldsGrow);
+
+    log_level_combo = new QComboBox(tab_behavior);
+    log_level_combo->addItem("Debug (tudo)", "debug");
+    log_level_combo->addItem("Informações", "info");
+    log_level_combo->addItem("Avisos", "warning");
+    log_level_combo->addItem("Apenas erros", "error");
+    log_level_combo->setToolTip("Mensagens abaixo deste nível não vão para o log do OBS. Linhas de debug ficam sempre guardadas em memória e podem ser exportadas pelo botão abaixo.");
+    log_level_combo->setCursor(Qt::PointingHandCursor);
+    log_level_combo->setMinimumWidth(200);
+    form_diagnostics->addRow("Nível de log:", log_level_combo);
+    layout_diagnostics->addLayout(form_diagnostics);
+
+    trace_capture_check = new QCheckBox("Gravar trace do feed (para reproduzir erros de detecção)", tab_behavior);
+    trace_capture_check->setToolTip("Grava cada resposta que mudou em um arquivo .aht na pasta de configuração do plugin (traces/). Use com a ferramenta auto-hide-replay.");
+    layout_diagnostics->addWidget(trace_capture_check);
+
+    QPushButton *dump_log_button = new QPushButton("Exportar log de debug", tab_behavior);
+    dump_log_button->setToolTip("Escreve no log do OBS as últimas linhas de debug guardadas em memória.");
+    dump_log_button->setCursor(Qt::PointingHandCursor);
+    dump_log_button->setMaximumWidth(240);
+    layout_diagnostics->addWidget(dump_log_button);
+
+    connect(dump_log_button, &QPushButton::clicked, this, &SettingsDialog::dump_debug_log);
+
+    layout_behavior_tab->addWidget(group_diagnostics);
     layout_behavior_tab->addStretch();
 
     tab_widget->addTab(tab_behavior, "⚙️ Comportamento");
@@ -339,17 +478,45 @@ void SettingsDialog::setup_ui() {
 void SettingsDialog::load_current_values() {
     client_type_combo->setCurrentText(config.client_type);
     url_input->setText(config.holyrics_url);
+    backup_urls_input->setText(config.backup_urls.join(" "));
     interval_input->setValue(config.polling_interval_ms);
+    push_mode_check->setChecked(config.push_mode);
+    stream_path_input->setText(config.stream_path);
+    next_item_path_input->setText(config.next_item_path);
+    update_push_hint();
+    int transport_index = transport_combo->findData(config.transport);
+    transport_combo->setCurrentIndex(transport_index >= 0 ? transport_index : 0);
+    QStringList extra_lines;
+    for (const ClientEndpoint &endpoint : config.extra_clients) {
+        extra_lines.append((QStringList{endpoint.type, endpoint.url} + endpoint.backup_urls).join(" "));
+    }
+    extra_clients_input->setPlainText(extra_lines.join("\n"));
+    int combine_index = combine_combo->findData(config.client_combine);
+    combine_combo->setCurrentIndex(combine_index >= 0 ? combine_index : 0);
 
     scene_combo->setCurrentText(config.monitored_scene);
     on_scene_changed(config.monitored_scene);
 
     restore_state_check->setChecked(config.restore_previous_state);
-    delay_input->setValue(config.action_delay_ms);
+    hide_confirm_input->setValue(config.hide_confirm_ms);
+    show_confirm_input->setValue(config.show_confirm_ms);
+    min_dwell_input->setValue(config.min_dwell_ms);
     notifications_check->setChecked(config.show_notifications);
     auto_activate_check->setChecked(config.auto_activate);
     disable_in_music_check->setChecked(config.disable_in_music);
+    QStringList rule_lines;
+    for (auto it = config.content_rules.constBegin(); it != config.content_rules.constEnd(); ++it) {
+        rule_lines.append(it.key() + " = " + it.value());
+    }
+    content_rules_input->setPlainText(rule_lines.join("\n"));
     auto_transition_check->setChecked(config.auto_transition);
+    frame_aligned_check->setChecked(config.frame_aligned);
+    all_scenes_check->setChecked(config.all_scenes);
+
+    int log_level_index = log_level_combo->findData(
+        PluginLog::level_to_string(PluginLog::level_from_string(config.log_level)));
+    log_level_combo->setCurrentIndex(log_level_index >= 0 ? log_level_index : 1);
+    trace_capture_check->setChecked(config.trace_capture);
 }
 
 void SettingsDialog::on_scene_changed(const QString &scene_name) {
@@ -427,7 +594,26 @@ void SettingsDialog::test_connection() {
 void SettingsDialog::save() {
     config.client_type = client_type_combo->currentText();
     config.holyrics_url = url_input->text();
+    config.backup_urls = backup_urls_input->text().simplified().split(' ', Qt::SkipEmptyParts);
     config.polling_interval_ms = interval_input->value();
+    config.push_mode = push_mode_check->isChecked();
+    config.stream_path = stream_path_input->text().trimmed();
+    config.next_item_path = next_item_path_input->text().trimmed();
+    config.transport = transport_combo->currentData().toString();
+    config.extra_clients.clear();
+    for (const QString &line : extra_clients_input->toPlainText().split('\n')) {
+        QStringList parts = line.simplified().split(' ');
+        if (parts.size() < 2) {
+            continue;
+        }
+        ClientEndpoint endpoint;
+        endpoint.type = parts[0].compare("ProPresent", Qt::CaseInsensitive) == 0 ? "ProPresent" : "Holyrics";
+        endpoint.url = parts[1];
+        // Demais URLs da linha: reservas, em ordem
+        endpoint.backup_urls = parts.mid(2);
+        config.extra_clients.append(endpoint);
+    }
+    config.client_combine = combine_combo->currentData().toString();
     config.monitored_scene = scene_combo->currentText();
 
     config.sources_to_hide.clear();
@@ -439,13 +625,48 @@ void SettingsDialog::save() {
     }
 
     config.restore_previous_state = restore_state_check->isChecked();
-    config.action_delay_ms = delay_input->value();
+    config.hide_confirm_ms = hide_confirm_input->value();
+    config.show_confirm_ms = show_confirm_input->value();
+    config.min_dwell_ms = min_dwell_input->value();
     config.show_notifications = notifications_check->isChecked();
     config.auto_activate = auto_activate_check->isChecked();
     config.disable_in_music = disable_in_music_check->isChecked();
+    // Linhas apagadas voltam ao perfil padrão do tipo
+    config.content_rules = default_content_rules();
+    for (const QString &line : content_rules_input->toPlainText().split('\n')) {
+        int separator = line.indexOf('=');
+        if (separator < 0) {
+            continue;
+        }
+        QString type = line.left(separator).trimmed().toUpper();
+        QString profile = line.mid(separator + 1).trimmed().toLower();
+        ContentAction action;
+        if (!content_action_from_string(profile, action)) {
+            continue;
+        }
+        config.content_rules[type] = profile;
+    }
     config.auto_transition = auto_transition_check->isChecked();
+    config.frame_aligned = frame_aligned_check->isChecked();
+    config.all_scenes = all_scenes_check->isChecked();
+    config.log_level = log_level_combo->currentData().toString();
+    config.trace_capture = trace_capture_check->isChecked();
 
     accept();
 }
 
 void SettingsDialog::add_source_manually() {}
+
+void SettingsDialog::update_push_hint() {
+    // Holyrics só tem push com o caminho do stream; sem ele fica no polling
+    push_hint_label->setVisible(push_mode_check->isChecked() &&
+                                client_type_combo->currentText() == "Holyrics" &&
+                                stream_path_input->text().trimmed().isEmpty());
+}
+
+void SettingsDialog::dump_debug_log() {
+    int lines = PluginLog::dump_recent_debug();
+    QMessageBox::information(this, "Log de debug",
+                             QString("%1 linhas de debug foram escritas no log do OBS.\n"
+                                     "Veja em Ajuda > Arquivos de log.").arg(lines));
+}
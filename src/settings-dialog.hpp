@@ -9,6 +9,7 @@
 #include <QLineEdit>
 #include <QListWidget>
 #include <QNetworkAccessManager>
+#include <QPlainTextEdit>
 #include <QPushButton>
 #include <QSpinBox>
 #include <QVBoxLayout>
@@ -26,6 +27,8 @@ private slots:
   void test_connection();
   void on_scene_changed(const QString &scene_name);
   void add_source_manually();
+  void dump_debug_log();
+  void update_push_hint();
 
 private:
   PluginConfig &config;
@@ -35,7 +38,15 @@ private:
   // UI Components
   QComboBox *client_type_combo;
   QLineEdit *url_input;
+  QLineEdit *backup_urls_input;
   QSpinBox *interval_input;
+  QCheckBox *push_mode_check;
+  QLineEdit *stream_path_input;
+  QLabel *push_hint_label;
+  QLineEdit *next_item_path_input;
+  QComboBox *transport_combo;
+  QPlainTextEdit *extra_clients_input;
+  QComboBox *combine_combo;
   QPushButton *test_button;
   QLabel *status_label;
 
@@ -43,11 +54,19 @@ private:
   QListWidget *sources_list;
 
   QCheckBox *restore_state_check;
-  QSpinBox *delay_input;
+  QSpinBox *hide_confirm_input;
+  QSpinBox *show_confirm_input;
+  QSpinBox *min_dwell_input;
   QCheckBox *notifications_check;
   QCheckBox *auto_activate_check;
   QCheckBox *disable_in_music_check;
+  QPlainTextEdit *content_rules_input;
   QCheckBox *auto_transition_check;
+  QCheckBox *frame_aligned_check;
+  QCheckBox *all_scenes_check;
+
+  QComboBox *log_level_combo;
+  QCheckBox *trace_capture_check;
 
   void setup_ui();
   void load_current_values();
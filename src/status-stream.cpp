@@ -0,0 +1,146 @@
+#include "status-stream.hpp"
+#include "plugin-log.hpp"
+
+// Limite de segurança para uma única mensagem (evita crescer sem fim se o
+// servidor enviar lixo sem fechar chaves)
+static constexpr int kMaxMessageBytes = 4 * 1024 * 1024;
+
+StatusStream::StatusStream(QNetworkAccessManager *manager, QObject *parent)
+    : QObject(parent), network_manager(manager) {}
+
+StatusStream::~StatusStream() { close(); }
+
+void StatusStream::open(const QNetworkRequest &request,
+                        const QByteArray &post_body) {
+  close();
+  reset_framing();
+
+  QNetworkRequest stream_request(request);
+  // Stream fica aberto indefinidamente: sem timeout de transferência
+  stream_request.setTransferTimeout(0);
+
+  if (post_body.isEmpty()) {
+    reply = network_manager->get(stream_request);
+  } else {
+    stream_request.setHeader(QNetworkRequest::ContentTypeHeader,
+                             "application/json");
+    reply = network_manager->post(stream_request, post_body);
+  }
+
+  QObject::connect(reply, &QNetworkReply::readyRead, this,
+                   &StatusStream::on_ready_read);
+  QObject::connect(reply, &QNetworkReply::finished, this,
+                   &StatusStream::on_finished);
+}
+
+void StatusStream::close() {
+  if (!reply)
+    return;
+
+  QNetworkReply *old_reply = reply;
+  reply = nullptr;
+  receiving = false;
+
+  QObject::disconnect(old_reply, nullptr, this, nullptr);
+  old_reply->abort();
+  old_reply->deleteLater();
+}
+
+void StatusStream::reset_framing() {
+  pending.clear();
+  depth = 0;
+  in_string = false;
+  escaped = false;
+}
+
+void StatusStream::on_ready_read() {
+  if (!reply)
+    return;
+
+  QNetworkReply *current = reply;
+
+  if (!receiving) {
+    int status =
+        current->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (status < 200 || status >= 300) {
+      // Deixa o finished reportar o erro
+      return;
+    }
+    receiving = true;
+    if (on_opened) {
+      on_opened();
+      if (reply != current)
+        return;
+    }
+  }
+
+  const QByteArray chunk = current->readAll();
+
+  for (char c : chunk) {
+    if (depth == 0) {
+      // Fora de um objeto: ignora separadores e prefixos
+      if (c != '{')
+        continue;
+      pending.clear();
+    }
+
+    pending.append(c);
+
+    if (in_string) {
+      if (escaped) {
+        escaped = false;
+      } else if (c == '\\') {
+        escaped = true;
+      } else if (c == '"') {
+        in_string = false;
+      }
+      continue;
+    }
+
+    if (c == '"') {
+      in_string = true;
+    } else if (c == '{' || c == '[') {
+      depth++;
+    } else if (c == '}' || c == ']') {
+      depth--;
+      if (depth == 0) {
+        QByteArray message = pending;
+        pending.clear();
+        if (on_message) {
+          on_message(message);
+          // O callback pode ter fechado/reaberto o stream
+          if (reply != current)
+            return;
+        }
+      }
+    }
+
+    if (pending.size() > kMaxMessageBytes) {
+      PluginLog::write(LogLevel::Warning,
+                       "[Auto Hide] Stream: mensagem excedeu %d bytes, descartando",
+                       kMaxMessageBytes);
+      reset_framing();
+    }
+  }
+}
+
+void StatusStream::on_finished() {
+  if (!reply)
+    return;
+
+  QString reason;
+  if (reply->error() != QNetworkReply::NoError) {
+    reason = reply->errorString();
+  } else {
+    reason = "Servidor encerrou o stream";
+  }
+
+  QNetworkReply *old_reply = reply;
+  reply = nullptr;
+  receiving = false;
+  old_reply->deleteLater();
+
+  if (on_dropped) {
+    on_dropped(reason);
+  }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QByteArray>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QObject>
+#include <QString>
+#include <functional>
+
+// Conexão HTTP longa (chunked) que entrega cada objeto JSON recebido como
+// uma mensagem separada. O separador entre mensagens não importa (quebra de
+// linha, "\r\n\r\n", prefixo "data:" de SSE): os objetos são delimitados
+// contando chaves fora de strings.
+class StatusStream : public QObject {
+  Q_OBJECT
+
+public:
+  explicit StatusStream(QNetworkAccessManager *manager,
+                        QObject *parent = nullptr);
+  ~StatusStream() override;
+
+  // Abre o stream. Com post_body vazio usa GET, senão POST com o corpo.
+  void open(const QNetworkRequest &request,
+            const QByteArray &post_body = QByteArray());
+  void close();
+
+  bool is_open() const { return reply != nullptr; }
+  bool is_receiving() const { return receiving; }
+
+  // Chamado no primeiro byte recebido com HTTP 2xx
+  std::function<void()> on_opened;
+  // Chamado para cada objeto JSON completo
+  std::function<void(const QByteArray &message)> on_message;
+  // Chamado quando a conexão cai ou o servidor recusa o stream
+  std::function<void(const QString &reason)> on_dropped;
+
+private:
+  QNetworkAccessManager *network_manager;
+  QNetworkReply *reply = nullptr;
+  bool receiving = false;
+
+  // Estado do separador de mensagens
+  QByteArray pending;
+  int depth = 0;
+  bool in_string = false;
+  bool escaped = false;
+
+  void on_ready_read();
+  void on_finished();
+  void reset_framing();
+};
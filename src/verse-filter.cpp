@@ -0,0 +1,84 @@
+#include "verse-filter.hpp"
+#include "plugin-log.hpp"
+#include <util/platform.h>
+#include <utility>
+
+VerseStateFilter::VerseStateFilter(QObject *parent) : QObject(parent) {
+  confirm_timer.setSingleShot(true);
+  connect(&confirm_timer, &QTimer::timeout, this, &VerseStateFilter::confirm);
+}
+
+void VerseStateFilter::set_timing(int hide_confirm, int show_confirm,
+                                  int min_dwell) {
+  hide_confirm_ms = qMax(0, hide_confirm);
+  show_confirm_ms = qMax(0, show_confirm);
+  min_dwell_ms = qMax(0, min_dwell);
+}
+
+void VerseStateFilter::submit(bool verse_visible,
+                              const TransitionTrace &trace) {
+  counters.raw_changes++;
+
+  if (verse_visible == stable_visible) {
+    // Voltou ao estado atual antes de confirmar: foi só uma piscada
+    if (candidate_pending) {
+      candidate_pending = false;
+      confirm_timer.stop();
+      counters.suppressed++;
+      PluginLog::write(LogLevel::Debug,
+                       "[Auto Hide DEBUG] Filtro: mudança para %s ignorada",
+                       verse_visible ? "SUMIU" : "APARECEU");
+    }
+    notify_stats();
+    return;
+  }
+
+  // Mesmo candidato já esperando: mantém o prazo original
+  if (candidate_pending)
+    return;
+
+  candidate_pending = true;
+  candidate_trace = trace;
+
+  const int confirm_ms = verse_visible ? hide_confirm_ms : show_confirm_ms;
+  int delay_ms = confirm_ms;
+  if (stable_since_ns != 0) {
+    const int64_t dwell_ms =
+        int64_t(os_gettime_ns() - stable_since_ns) / 1000000;
+    delay_ms = qMax<int>(delay_ms, int(qMax<int64_t>(0, min_dwell_ms - dwell_ms)));
+  }
+  confirm_timer.start(delay_ms);
+  notify_stats();
+}
+
+void VerseStateFilter::confirm() {
+  if (!candidate_pending)
+    return;
+
+  candidate_pending = false;
+  stable_visible = !stable_visible;
+  stable_since_ns = os_gettime_ns();
+  counters.confirmed++;
+
+  TransitionTrace trace = candidate_trace;
+  trace.timer_fired_ns = stable_since_ns;
+  if (on_state_confirmed)
+    on_state_confirmed(stable_visible, trace);
+  notify_stats();
+}
+
+void VerseStateFilter::reset() {
+  confirm_timer.stop();
+  candidate_pending = false;
+  stable_since_ns = 0;
+
+  // Versículo confirmado: a cena volta junto com o filtro (sem isso as
+  // fontes ficariam escondidas até o próximo versículo)
+  if (std::exchange(stable_visible, false) && on_state_confirmed)
+    on_state_confirmed(false, TransitionTrace());
+}
+
+void VerseStateFilter::notify_stats() {
+  if (on_stats_changed)
+    on_stats_changed(counters);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "latency-stats.hpp"
+#include <QObject>
+#include <QTimer>
+#include <cstdint>
+#include <functional>
+
+struct VerseFilterStats {
+  quint64 raw_changes = 0; // Mudanças vindas do cliente
+  quint64 confirmed = 0;   // Repassadas ao SceneController
+  quint64 suppressed = 0;  // Voltaram atrás antes de confirmar
+};
+
+// Filtro entre o cliente e a cena: uma mudança só vale depois de ficar
+// estável pelo tempo de confirmação (separado para versículo e fim), e o
+// estado de saída fica pelo menos min_dwell_ms antes de mudar de novo.
+// Absorve o slide BIBLE vazio entre versículos sem piscar as fontes.
+//
+// Vive na thread da UI.
+class VerseStateFilter : public QObject {
+  Q_OBJECT
+
+public:
+  explicit VerseStateFilter(QObject *parent = nullptr);
+
+  void set_timing(int hide_confirm_ms, int show_confirm_ms, int min_dwell_ms);
+
+  // Estado bruto do cliente
+  void submit(bool verse_visible, const TransitionTrace &trace);
+  // Descarta a mudança pendente e volta ao estado "sem versículo". Se o
+  // versículo estava confirmado, emite on_state_confirmed(false).
+  void reset();
+
+  bool state() const { return stable_visible; }
+  // "Sem versículo" confirmado e nenhuma mudança esperando confirmação
+  bool is_idle() const { return !stable_visible && !candidate_pending; }
+  const VerseFilterStats &stats() const { return counters; }
+
+  std::function<void(bool verse_visible, const TransitionTrace &trace)>
+      on_state_confirmed;
+  // Chamado quando os contadores mudam
+  std::function<void(const VerseFilterStats &stats)> on_stats_changed;
+
+private:
+  QTimer confirm_timer;
+  int hide_confirm_ms = 150;
+  int show_confirm_ms = 400;
+  int min_dwell_ms = 1000;
+
+  bool stable_visible = false;
+  uint64_t stable_since_ns = 0;
+  bool candidate_pending = false;
+  TransitionTrace candidate_trace;
+
+  VerseFilterStats counters;
+
+  void confirm();
+  void notify_stats();
+};